@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "Experiment.h"
+#include "../simulation/CreatureFile.h"
+#include "../utils/Random.h"
+
+namespace {
+    double parse_number(const std::string &word) {
+        std::size_t end = 0;
+        double value = 0;
+        try {
+            value = std::stod(word, &end);
+        } catch (const std::logic_error &) {}
+        if (end == 0 || end != word.size()) throw std::invalid_argument("Not a number: " + word);
+        return value;
+    }
+
+    long parse_integer(const std::string &word) {
+        std::size_t end = 0;
+        long value = 0;
+        try {
+            value = std::stol(word, &end);
+        } catch (const std::logic_error &) {}
+        if (end == 0 || end != word.size()) throw std::invalid_argument("Not an integer: " + word);
+        return value;
+    }
+
+    const std::string &single(const std::string &name, const std::vector<std::string> &words) {
+        if (words.size() != 1) throw std::invalid_argument(name + " takes one value");
+        return words.front();
+    }
+}
+
+const std::vector<std::string> Experiment::parameter_names = {
+        "enable_gene_chance", "weight_mutation_chance", "set_weight_chance", "add_node_mutation_chance",
+        "add_connection_mutation_chance", "non_crossover_breeding_rate", "selection_rate", "tournament_size",
+        "compatibility_threshold", "c1", "c2", "c3"
+};
+
+Experiment::Experiment() : creature(default_creature()) {}
+
+Scenario Experiment::default_creature() {
+    Scenario scenario;
+    scenario.points = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    scenario.connections = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {0, 2}};
+    return scenario;
+}
+
+std::vector<Scenario> Experiment::with_terrains(const Scenario &creature, int count, double roughness) {
+    std::vector<Scenario> scenarios(count + 1, creature);
+    for (int i = 1; i <= count; i++) {
+        scenarios[i].terrain = std::make_shared<const Terrain>(Terrain::generate(i, roughness));
+    }
+    return scenarios;
+}
+
+Experiment Experiment::load(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Can't open experiment " + path);
+    }
+
+    Experiment experiment;
+    std::string line;
+    for (int number = 1; std::getline(file, line); number++) {
+        std::istringstream stream(line.substr(0, line.find('#')));
+        std::string name, word;
+        std::vector<std::string> words;
+        if (!(stream >> name)) continue;
+        while (stream >> word) {
+            words.push_back(word);
+        }
+
+        try {
+            experiment.set(name, words);
+        } catch (const std::exception &e) {
+            throw std::runtime_error(path + ":" + std::to_string(number) + ": " + e.what());
+        }
+    }
+    return experiment;
+}
+
+void Experiment::set(const std::string &name, const std::vector<std::string> &words) {
+    if (words.empty()) {
+        throw std::invalid_argument(name + " has no value");
+    }
+
+    if (name == "creature") {
+        creature = CreatureFile::load(single(name, words));
+    } else if (name == "generations") {
+        generations = (int) parse_integer(single(name, words));
+    } else if (name == "steps") {
+        steps = (int) parse_integer(single(name, words));
+    } else if (name == "delta") {
+        delta = parse_number(single(name, words));
+    } else if (name == "terrains") {
+        terrains = (int) parse_integer(single(name, words));
+        if (terrains < 0) throw std::invalid_argument("Negative number of terrains");
+    } else if (name == "roughness") {
+        roughness = parse_number(single(name, words));
+    } else if (name == "collision") {
+        collision = parse_number(single(name, words));
+    } else if (name == "threads") {
+        threads = (int) parse_integer(single(name, words));
+    } else if (name == "concurrent") {
+        concurrent = (int) parse_integer(single(name, words));
+    } else if (name == "search") {
+        const std::string &method = single(name, words);
+        if (method != "grid" && method != "random") throw std::invalid_argument("Unknown search " + method);
+        search = method == "grid" ? Search::Grid : Search::Random;
+    } else if (name == "samples") {
+        samples = (int) parse_integer(single(name, words));
+    } else if (name == "search_seed") {
+        search_seed = (unsigned int) parse_integer(single(name, words));
+    } else if (name == "seeds") {
+        seeds.clear();
+        for (const auto &word: words) {
+            seeds.push_back((unsigned int) parse_integer(word));
+        }
+    } else if (name == "output") {
+        output = single(name, words);
+    } else if (name == "population" ||
+               std::find(parameter_names.begin(), parameter_names.end(), name) != parameter_names.end()) {
+        Parameter parameter;
+        parameter.name = name;
+        std::size_t separator = words.front().find("..");
+        if (separator != std::string::npos) {
+            if (words.size() != 1) throw std::invalid_argument("Range of " + name + " must be its only value");
+            parameter.low = parse_number(words.front().substr(0, separator));
+            parameter.high = parse_number(words.front().substr(separator + 2));
+            if (!(parameter.low <= parameter.high)) throw std::invalid_argument("Empty range of " + name);
+        } else {
+            for (const auto &word: words) {
+                parameter.values.push_back(parse_number(word));
+            }
+        }
+
+        std::erase_if(parameters, [&name](const Parameter &p) { return p.name == name; });
+        parameters.push_back(parameter);
+    } else {
+        throw std::invalid_argument("Unknown setting " + name);
+    }
+}
+
+std::vector<Run> Experiment::expand() const {
+    std::vector<std::vector<double>> settings;
+    if (search == Search::Grid) {
+        settings.emplace_back();
+        for (const auto &parameter: parameters) {
+            if (parameter.values.empty()) {
+                throw std::invalid_argument("Range of " + parameter.name + " needs random search");
+            }
+            std::vector<std::vector<double>> extended;
+            extended.reserve(settings.size() * parameter.values.size());
+            for (const auto &setting: settings) {
+                for (double value: parameter.values) {
+                    extended.push_back(setting);
+                    extended.back().push_back(value);
+                }
+            }
+            settings = std::move(extended);
+        }
+    } else {
+        Random random(search_seed);
+        for (int s = 0; s < samples; s++) {
+            auto &setting = settings.emplace_back();
+            for (const auto &parameter: parameters) {
+                setting.push_back(parameter.values.empty()
+                                  ? random.uniform(parameter.low, parameter.high)
+                                  : parameter.values[random.integer((int) parameter.values.size())]);
+            }
+        }
+    }
+
+    std::vector<Run> runs;
+    runs.reserve(settings.size() * seeds.size());
+    for (const auto &setting: settings) {
+        for (unsigned int seed: seeds) {
+            Run &run = runs.emplace_back();
+            run.index = (int) runs.size() - 1;
+            run.values = setting;
+            run.seed = seed;
+        }
+    }
+    return runs;
+}
+
+void Experiment::apply(Population &population, const std::string &name, double value) {
+    if (name == "enable_gene_chance") population.enable_gene_chance = value;
+    else if (name == "weight_mutation_chance") population.weight_mutation_chance = value;
+    else if (name == "set_weight_chance") population.set_weight_chance = value;
+    else if (name == "add_node_mutation_chance") population.add_node_mutation_chance = value;
+    else if (name == "add_connection_mutation_chance") population.add_connection_mutation_chance = value;
+    else if (name == "non_crossover_breeding_rate") population.non_crossover_breeding_rate = value;
+    else if (name == "selection_rate") population.selection_rate = value;
+    else if (name == "tournament_size") population.tournament_size = std::max(1, (int) std::lround(value));
+    else if (name == "compatibility_threshold") population.compatibility_threshold = value;
+    else if (name == "c1") population.c1 = value;
+    else if (name == "c2") population.c2 = value;
+    else if (name == "c3") population.c3 = value;
+}
+
+ScenarioSet::Run Experiment::distance_run(EpisodeController &episodes, double delta) {
+    return [&episodes, delta](Creature &creature, const Scenario &, double cutoff, double *fitness) {
+        // Progress is distance, fitness is one more
+        Episode episode = episodes.start(cutoff - 1);
+        do {
+            creature.timestep(delta);
+        } while (episode.report(creature));
+        fitness[0] = episode.reason == StopReason::Exploded ? 0 : std::max(0.0, 1.0 + creature.distance_ran());
+    };
+}
+
+ScenarioSet::BatchRun Experiment::distance_batch_run(EpisodeController &episodes, double delta) {
+    return [&episodes, delta](CreatureBatch &batch, const Scenario &, int lanes, const double *cutoffs,
+                              double *fitness) {
+        std::vector<Episode> running;
+        running.reserve(lanes);
+        for (int lane = 0; lane < lanes; lane++) {
+            running.push_back(episodes.start(cutoffs[lane] - 1));
+        }
+
+        int remaining = lanes;
+        while (remaining > 0) {
+            batch.timestep(delta);
+            for (int lane = 0; lane < lanes; lane++) {
+                Episode &episode = running[lane];
+                if (episode.finished || episode.report(batch.distance_ran(lane), batch.extent(lane))) continue;
+                fitness[lane] = episode.reason == StopReason::Exploded
+                                ? 0 : std::max(0.0, 1.0 + batch.distance_ran(lane));
+                remaining--;
+            }
+        }
+    };
+}
+
+void Experiment::execute(Run &run, ThreadPool &pool) const {
+    auto start = std::chrono::steady_clock::now();
+
+    int size = 150;
+    for (std::size_t i = 0; i < parameters.size(); i++) {
+        if (parameters[i].name == "population") size = (int) std::lround(run.values[i]);
+    }
+    if (size < 2) {
+        throw std::invalid_argument("Population size must be at least 2");
+    }
+
+    EpisodeController episodes;
+    episodes.max_steps = steps;
+    episodes.max_progress_rate = 10 * delta;
+    Scenario colliding = creature;
+    colliding.collision_radius = collision;
+    ScenarioSet scenario_set(with_terrains(colliding, terrains, roughness), pool, distance_run(episodes, delta));
+
+    Population population(size, creature.input_count(), creature.output_count(), std::ref(scenario_set), run.seed,
+                          [this, &run](Population &p) {
+                              for (std::size_t i = 0; i < parameters.size(); i++) {
+                                  apply(p, parameters[i].name, run.values[i]);
+                              }
+                          });
+
+    run.best_fitness = population.best_fitness;
+    while (population.generation < generations) {
+        population.evolution_step();
+        run.best_fitness = std::max(run.best_fitness, population.best_fitness);
+    }
+
+    run.average_fitness = population.average_fitness;
+    run.species = (int) population.species.size();
+    run.generations = population.generation;
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Experiment::run(std::vector<Run> &runs, std::ostream &log) const {
+    ThreadPool pool(threads);
+    int driver_count = concurrent > 0 ? concurrent : pool.thread_count();
+    driver_count = std::max(1, std::min(driver_count, (int) runs.size()));
+
+    std::atomic<int> next = 0;
+    std::atomic<int> finished = 0;
+    std::mutex log_mutex;
+    auto drive = [&] {
+        for (int i = next++; i < (int) runs.size(); i = next++) {
+            Run &run = runs[i];
+            try {
+                execute(run, pool);
+            } catch (const std::exception &e) {
+                run.error = e.what();
+            }
+
+            std::lock_guard lock(log_mutex);
+            log << "run " << run.index << " (" << ++finished << "/" << runs.size() << "): ";
+            if (run.error.empty()) {
+                log << "best " << run.best_fitness << " in " << run.seconds << " s" << std::endl;
+            } else {
+                log << run.error << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> drivers;
+    drivers.reserve(driver_count);
+    for (int d = 0; d < driver_count; d++) {
+        drivers.emplace_back(drive);
+    }
+    for (auto &driver: drivers) {
+        driver.join();
+    }
+}
+
+void Experiment::write_results(const std::vector<Run> &runs, std::ostream &stream) const {
+    stream << "run\tseed";
+    for (const auto &parameter: parameters) {
+        stream << '\t' << parameter.name;
+    }
+    stream << "\tbest\taverage\tspecies\tgenerations\tseconds\terror\n";
+
+    for (const auto &run: runs) {
+        stream << run.index << '\t' << run.seed;
+        for (double value: run.values) {
+            stream << '\t' << value;
+        }
+        stream << '\t' << run.best_fitness << '\t' << run.average_fitness << '\t' << run.species << '\t'
+               << run.generations << '\t' << run.seconds << '\t' << (run.error.empty() ? "-" : run.error) << '\n';
+    }
+    stream.flush();
+}
@@ -0,0 +1,197 @@
+#ifndef NEAT_EXPERIMENT_H
+#define NEAT_EXPERIMENT_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "../neat/Population.h"
+#include "../simulation/Episode.h"
+#include "../simulation/ScenarioSet.h"
+#include "../utils/ThreadPool.h"
+
+/**
+ * Hyperparameter varied between runs of an experiment.
+ * Has either a list of values, or a range [low, high] sampled by random search.
+ */
+struct Parameter {
+    std::string name;
+    std::vector<double> values;
+    double low = 0;
+    double high = 0;
+};
+
+/**
+ * Method of choosing hyperparameter settings.
+ */
+enum class Search {
+    Grid,  /// every combination of listed values
+    Random /// samples settings, each parameter drawn independently
+};
+
+/**
+ * A single evolution run of an experiment and its results.
+ */
+struct Run {
+    int index = 0;
+
+    /**
+     * Value of each parameter of the experiment.
+     */
+    std::vector<double> values;
+    unsigned int seed = 0;
+
+    double best_fitness = 0;
+    double average_fitness = 0;
+    int species = 0;
+    int generations = 0;
+    double seconds = 0;
+
+    /**
+     * Message of the exception that stopped the run, empty if it finished.
+     */
+    std::string error;
+};
+
+/**
+ * Set of evolution runs of one creature with different hyperparameters and seeds.
+ *
+ * Configured from a text file of lines "name value...", # starts a comment:
+ *
+ *     creature walker.creature   # creature file, a square with a diagonal if not given
+ *     generations 100
+ *     steps 500
+ *     delta 0.01
+ *     terrains 3                 # also evaluate on 3 generated hilly terrains, mean of all scores
+ *     roughness 0.3              # of generated terrains (see Terrain::generate)
+ *     collision 0.05             # radius of self-colliding points, no self-collision if 0
+ *     threads 8                  # total simulation threads, all cores if 0
+ *     concurrent 4               # runs evolving at the same time, as many as threads if 0
+ *     search grid                # or random
+ *     samples 20                 # settings drawn by random search
+ *     search_seed 1
+ *     seeds 1 2 3                # every setting is run with every seed
+ *     output results.tsv         # results table, standard output if not given
+ *     population 100 150         # parameters: list of values...
+ *     compatibility_threshold 1..5 # ...or a range (random search only)
+ *
+ * Parameters are population (size) and the hyperparameters of Population (see parameter_names).
+ *
+ * All runs share one thread pool, so the total number of simulation threads stays within the budget however
+ * many runs evolve at once. Each evolving run has a driver thread doing reproduction, which waits while its
+ * generation is simulated.
+ */
+class Experiment {
+private:
+    /**
+     * Set a hyperparameter of a population.
+     * @param population
+     * @param name name of a Population hyperparameter
+     * @param value
+     */
+    static void apply(Population &population, const std::string &name, double value);
+
+    /**
+     * Evolve a population with settings of a run and store its results.
+     * @param run run to execute
+     * @param pool threads simulating creatures
+     */
+    void execute(Run &run, ThreadPool &pool) const;
+
+public:
+    Scenario creature;
+    int generations = 100;
+    int steps = 500;
+    double delta = 0.01;
+    int terrains = 0;
+    double roughness = 0.3;
+    double collision = 0;
+    int threads = 0;
+    int concurrent = 0;
+
+    Search search = Search::Grid;
+    int samples = 10;
+    unsigned int search_seed = 0;
+
+    std::vector<unsigned int> seeds = {0};
+    std::vector<Parameter> parameters;
+    std::string output;
+
+    /**
+     * Names accepted as parameters, besides population.
+     */
+    static const std::vector<std::string> parameter_names;
+
+    /**
+     * Create an experiment with the default creature and a single run.
+     */
+    Experiment();
+
+    /**
+     * @return square braced with a diagonal
+     */
+    static Scenario default_creature();
+
+    /**
+     * Create scenarios of a creature on flat ground and on generated terrains, with seeds 1 to count,
+     * so all runs see the same terrains.
+     * @param creature
+     * @param count number of terrains
+     * @param roughness roughness of terrains
+     * @return count + 1 scenarios, flat ground first
+     */
+    static std::vector<Scenario> with_terrains(const Scenario &creature, int count, double roughness);
+
+    /**
+     * Read an experiment configuration. Throws std::runtime_error if it can't be read or is malformed.
+     * @param path path to the configuration file
+     * @return configured experiment
+     */
+    static Experiment load(const std::string &path);
+
+    /**
+     * Set a configuration value, replacing an earlier one. Throws std::invalid_argument if it is malformed.
+     * @param name name of a setting or a parameter
+     * @param words values
+     */
+    void set(const std::string &name, const std::vector<std::string> &words);
+
+    /**
+     * Create runs of all settings (chosen by search) with all seeds.
+     * @return runs in order of their index
+     */
+    [[nodiscard]] std::vector<Run> expand() const;
+
+    /**
+     * Simulate a creature for steps and score it by distance ran. Episodes stop early when the creature stalls.
+     * @param episodes controller of episodes
+     * @param delta timestep length
+     * @return scoring function of a scenario set
+     */
+    static ScenarioSet::Run distance_run(EpisodeController &episodes, double delta);
+
+    /**
+     * Score a batch of creatures like distance_run. Each lane has its own episode, the batch is simulated until
+     * all of them stop, so stopped lanes keep running (their scores are taken when they stop).
+     * @param episodes controller of episodes
+     * @param delta timestep length
+     * @return batch scoring function of a scenario set
+     */
+    static ScenarioSet::BatchRun distance_batch_run(EpisodeController &episodes, double delta);
+
+    /**
+     * Execute runs on concurrent driver threads. Runs that fail keep their error and don't stop the others.
+     * @param runs runs to execute
+     * @param log stream receiving a line as each run finishes
+     */
+    void run(std::vector<Run> &runs, std::ostream &log) const;
+
+    /**
+     * Write a table of runs, one tab-separated line per run.
+     * @param runs executed runs
+     * @param stream stream to write to
+     */
+    void write_results(const std::vector<Run> &runs, std::ostream &stream) const;
+};
+
+#endif
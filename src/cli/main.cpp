@@ -0,0 +1,603 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "Experiment.h"
+#include "../neat/Archive.h"
+#include "../neat/Checkpoint.h"
+#include "../neat/Population.h"
+#include "../simulation/CreatureBatch.h"
+#include "../simulation/CreatureFile.h"
+#include "../simulation/Episode.h"
+#include "../simulation/Recording.h"
+#include "../simulation/ScenarioSet.h"
+#include "../utils/Random.h"
+#include "../utils/ThreadPool.h"
+
+namespace {
+    /**
+     * Command line options of the form --name value.
+     */
+    class Options {
+    private:
+        std::map<std::string, std::string> values;
+
+    public:
+        Options(int argc, char **argv) {
+            for (int i = 0; i < argc; i += 2) {
+                std::string name = argv[i];
+                if (name.rfind("--", 0) != 0 || i + 1 >= argc) {
+                    throw std::invalid_argument("Expected --name value, got " + name);
+                }
+                values[name.substr(2)] = argv[i + 1];
+            }
+        }
+
+        [[nodiscard]] bool contains(const std::string &name) const {
+            return values.contains(name);
+        }
+
+        [[nodiscard]] std::string get(const std::string &name, const std::string &default_value) const {
+            auto it = values.find(name);
+            return it != values.end() ? it->second : default_value;
+        }
+
+        [[nodiscard]] long get(const std::string &name, long default_value) const {
+            auto it = values.find(name);
+            return it != values.end() ? std::stol(it->second) : default_value;
+        }
+
+        [[nodiscard]] double get(const std::string &name, double default_value) const {
+            auto it = values.find(name);
+            return it != values.end() ? std::stod(it->second) : default_value;
+        }
+
+        [[nodiscard]] const std::map<std::string, std::string> &all() const {
+            return values;
+        }
+    };
+
+    int evolve(const Options &options) {
+        const int generations = (int) options.get("generations", 100L);
+        const int steps = (int) options.get("steps", 500L);
+        const double delta = options.get("delta", 0.01);
+        const std::string checkpoint_path = options.get("checkpoint", std::string());
+        const std::string archive_path = options.get("archive", std::string());
+
+        ThreadPool pool((int) options.get("threads", 0L));
+        EpisodeController episodes;
+        episodes.max_steps = steps;
+        episodes.max_progress_rate = 10 * delta;
+
+        Scenario scenario = options.contains("creature") ? CreatureFile::load(options.get("creature", std::string()))
+                                                         : Experiment::default_creature();
+        scenario.collision_radius = options.get("collision", 0.0);
+        ScenarioSet scenario_set(Experiment::with_terrains(scenario, (int) options.get("terrains", 0L),
+                                                           options.get("roughness", 0.3)),
+                                 pool, Experiment::distance_run(episodes, delta));
+        // Batches give the same scores, bit for bit, they only simulate faster
+        const int batch_size = (int) options.get("batch", 0L);
+        if (batch_size > 0) {
+            scenario_set.batch_run = Experiment::distance_batch_run(episodes, delta);
+            scenario_set.batch_size = batch_size;
+        }
+        std::function<void(std::vector<NetworkGenome> &)> evaluation = std::ref(scenario_set);
+
+        std::unique_ptr<Population> population;
+        if (options.contains("resume")) {
+            population = Checkpoint::load(options.get("resume", std::string()), evaluation);
+        } else {
+            population = std::make_unique<Population>((int) options.get("population", 150L),
+                                                      scenario.input_count(), scenario.output_count(), evaluation,
+                                                      (unsigned int) options.get("seed", (long) time(nullptr)));
+        }
+
+        population->surrogate.enabled = options.get("surrogate", 0L) != 0;
+
+        Checkpoint::Writer checkpoint;
+        std::unique_ptr<Archive::Writer> archive;
+        if (!archive_path.empty()) {
+            archive = std::make_unique<Archive::Writer>(archive_path, population->generation);
+        }
+
+        while (population->generation < generations) {
+            std::cout << population->generation << ": " << population->best_fitness << ", "
+                      << population->average_fitness << ", " << population->species.size() << std::endl;
+            const Surrogate &surrogate = population->surrogate;
+            if (surrogate.enabled && surrogate.ready()) {
+                std::cout << "  surrogate: correlation " << surrogate.correlation << ", error " << surrogate.error
+                          << ", " << surrogate.skipped << " skipped, " << surrogate.seconds_saved << " s saved"
+                          << std::endl;
+            }
+            if (archive) archive->append(*population);
+            population->evolution_step();
+
+            if (!checkpoint_path.empty() && population->generation % 10 == 0) {
+                checkpoint.save(*population, checkpoint_path);
+            }
+        }
+        checkpoint.wait();
+
+        std::cout << "best " << population->best_fitness << ", stopped early: "
+                  << episodes.count(StopReason::Stalled) << " stalled, "
+                  << episodes.count(StopReason::CannotBeatCutoff) << " below cutoff, "
+                  << episodes.count(StopReason::Exploded) << " exploded, "
+                  << episodes.steps_saved << " of " << episodes.steps_saved + episodes.steps_run << " steps saved"
+                  << std::endl;
+        return 0;
+    }
+
+    int batch(const Options &options) {
+        Experiment experiment = options.contains("config") ? Experiment::load(options.get("config", std::string()))
+                                                           : Experiment();
+
+        // Other options override the configuration, values separated by spaces
+        for (const auto &[name, value]: options.all()) {
+            if (name == "config") continue;
+            std::istringstream stream(value);
+            std::vector<std::string> words;
+            for (std::string word; stream >> word;) {
+                words.push_back(word);
+            }
+            experiment.set(name, words);
+        }
+
+        std::vector<Run> runs = experiment.expand();
+        std::cerr << runs.size() << " runs" << std::endl;
+        experiment.run(runs, std::cerr);
+
+        if (experiment.output.empty()) {
+            experiment.write_results(runs, std::cout);
+        } else {
+            std::ofstream file(experiment.output);
+            experiment.write_results(runs, file);
+            if (!file) {
+                throw std::runtime_error("Can't write results " + experiment.output);
+            }
+        }
+
+        bool failed = std::any_of(runs.begin(), runs.end(), [](const Run &run) { return !run.error.empty(); });
+        return failed ? 1 : 0;
+    }
+
+    /**
+     * Square lattice of size x size points braced with diagonals, a creature with many sticks.
+     */
+    Scenario lattice(int size) {
+        Scenario scenario;
+        for (int row = 0; row < size; row++) {
+            for (int column = 0; column < size; column++) {
+                scenario.points.emplace_back(0.5 * column, 0.5 * row);
+                const int point = row * size + column;
+                if (column > 0) scenario.connections.emplace_back(point - 1, point);
+                if (row > 0) scenario.connections.emplace_back(point - size, point);
+                if (row > 0 && column > 0) scenario.connections.emplace_back(point - size - 1, point);
+            }
+        }
+        return scenario;
+    }
+
+    /**
+     * Simulate the same creatures one by one and as a batch, then compare the speed and the results.
+     * With --networks, creatures are controlled by random networks of a new population.
+     * With --terrain <seed>, they walk on generated terrain instead of flat ground.
+     * With --collision <radius>, copies of the creatures are also simulated with self-collision, and in free fall
+     * to check that collisions conserve momentum (fails if centres drift sideways).
+     * With --record <path>, copies of the creatures are also simulated while recording, one after another into
+     * the same file, which keeps the recording of the last one.
+     */
+    int physics(const Options &options) {
+        const int count = (int) options.get("creatures", 256L);
+        const int steps = (int) options.get("steps", 1000L);
+        const double delta = options.get("delta", 0.01);
+        const bool fast = options.get("fast", 0L) != 0;
+        const double tolerance = options.get("tolerance", 0.0);
+        const int max_iterations = (int) options.get("max_iterations", 20L);
+        Scenario scenario = options.contains("creature") ? CreatureFile::load(options.get("creature", std::string()))
+                          : options.contains("lattice") ? lattice((int) options.get("lattice", 2L))
+                                                        : Experiment::default_creature();
+
+        const long seed = options.get("seed", 1L);
+        if (options.contains("terrain")) {
+            scenario.terrain = std::make_shared<const Terrain>(Terrain::generate(options.get("terrain", 1L)));
+        }
+        std::vector<std::unique_ptr<FastNetwork>> networks;
+        if (options.get("networks", 0L) != 0) {
+            Population population(count, scenario.input_count(), scenario.output_count(),
+                                  [](std::vector<NetworkGenome> &) {}, (unsigned int) seed);
+            for (const auto &genome: population.genomes) {
+                networks.push_back(std::make_unique<FastNetwork>(genome));
+            }
+        }
+
+        // Creatures start in different poses, so lanes don't stay identical
+        Random random((std::uint64_t) seed);
+        std::vector<std::unique_ptr<Creature>> creatures;
+        for (int i = 0; i < count; i++) {
+            scenario.rotation = random.uniform(-0.5, 0.5);
+            scenario.offset = Vector2D(0, random.uniform(0, 0.5));
+            const FastNetwork *network = networks.empty() ? nullptr : networks[i].get();
+            creatures.push_back(ScenarioSet::create_creature(scenario, network));
+            creatures.back()->fast_inverse_sqrt = fast;
+            creatures.back()->constraint_tolerance = tolerance;
+            creatures.back()->max_constraint_iterations = max_iterations;
+        }
+
+        CreatureBatch batch(*creatures.front(), count);
+        for (int i = 0; i < count; i++) {
+            batch.load(i, *creatures[i]);
+        }
+
+        // Same creatures with self-collision, batches don't collide
+        const double collision = options.get("collision", 0.0);
+        std::vector<std::unique_ptr<Creature>> colliding;
+        // Same colliding creatures in free fall, high above the ground. Nothing pushes them sideways, so their
+        // centres stay in place unless contacts create momentum, which creatures could use to move.
+        std::vector<std::unique_ptr<Creature>> falling;
+        const double height = (double) steps * steps * delta;
+        if (collision > 0) {
+            for (const auto &creature: creatures) {
+                colliding.push_back(std::make_unique<Creature>(*creature));
+                colliding.back()->collision_radius = collision;
+                falling.push_back(std::make_unique<Creature>(*colliding.back()));
+                for (auto &point: falling.back()->points) {
+                    point.position.y += height;
+                    point.old_position.y += height;
+                }
+            }
+        }
+
+        // Same creatures recorded
+        std::vector<std::unique_ptr<Creature>> recorded;
+        if (options.contains("record")) {
+            for (const auto &creature: creatures) {
+                recorded.push_back(std::make_unique<Creature>(*creature));
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto &creature: creatures) {
+            for (int step = 0; step < steps; step++) {
+                creature->timestep(delta);
+            }
+        }
+        double scalar_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (int step = 0; step < steps; step++) {
+            batch.timestep(delta);
+        }
+        double batch_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Creatures exploded by their networks are NaN in both simulations
+        auto equal = [](double a, double b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+        double difference = 0;
+        int different_lanes = 0;
+        for (int i = 0; i < count; i++) {
+            bool same = equal(batch.highest_jump[i], creatures[i]->highest_jump) &&
+                        equal(batch.energy_spent[i], creatures[i]->energy_spent);
+            for (int p = 0; p < batch.point_count; p++) {
+                const Vector2D &position = creatures[i]->points[p].position;
+                const std::size_t index = (std::size_t) p * count + i;
+                difference = std::max({difference, std::abs(batch.x[index] - position.x),
+                                       std::abs(batch.y[index] - position.y)});
+                same = same && equal(batch.x[index], position.x) && equal(batch.y[index], position.y);
+            }
+            different_lanes += !same;
+        }
+
+        const double creature_steps = (double) count * steps;
+        std::cout << count << " creatures, " << batch.point_count << " points, " << batch.stick_count
+                  << " sticks in " << batch.colour_offsets.size() - 1 << " colours, " << steps << " steps"
+                  << (fast ? ", fast inverse square root" : "") << (networks.empty() ? "" : ", random networks")
+                  << (scenario.terrain == nullptr ? "" : ", terrain") << "\n"
+                  << "creatures: " << scalar_seconds << " s, " << creature_steps / scalar_seconds
+                  << " creature steps/s\n"
+                  << "batch:     " << batch_seconds << " s, " << creature_steps / batch_seconds
+                  << " creature steps/s (" << scalar_seconds / batch_seconds << "x)\n"
+                  << "largest difference " << difference << ", " << different_lanes << " lanes not identical"
+                  << std::endl;
+
+        bool momentum_kept = true;
+        if (!colliding.empty()) {
+            start = std::chrono::steady_clock::now();
+            for (auto &creature: colliding) {
+                for (int step = 0; step < steps; step++) {
+                    creature->timestep(delta);
+                }
+            }
+            double colliding_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            long contacts = 0;
+            for (const auto &creature: colliding) {
+                contacts += creature->contacts;
+            }
+            const double overhead = 1e9 * (colliding_seconds - scalar_seconds) / creature_steps;
+            std::cout << "collision: " << colliding_seconds << " s, " << creature_steps / colliding_seconds
+                      << " creature steps/s, " << overhead << " ns per creature step over creatures ("
+                      << overhead / batch.point_count << " per point), " << (double) contacts / creature_steps
+                      << " contacts per creature step" << std::endl;
+
+            double drift = 0;
+            for (auto &creature: falling) {
+                const double x = creature->centre().x;
+                for (int step = 0; step < steps; step++) {
+                    creature->timestep(delta);
+                }
+                // Exploded creatures are NaN
+                if (std::isfinite(creature->centre().x)) drift = std::max(drift, std::abs(creature->centre().x - x));
+            }
+            momentum_kept = drift < 1e-6;
+            std::cout << "largest sideways drift in free fall " << drift << std::endl;
+            if (!momentum_kept) {
+                std::cerr << "Collisions don't conserve momentum" << std::endl;
+            }
+        }
+
+        if (!recorded.empty()) {
+            const std::string path = options.get("record", std::string());
+            long bytes = 0;
+
+            // Only timesteps are timed, like other simulations, not opening and closing recordings
+            double recorded_seconds = 0;
+            for (auto &creature: recorded) {
+                Recording::Writer recorder(path, (int) creature->points.size(), scenario.connections, delta,
+                                           scenario.terrain.get());
+                recorder.record(creature->points);
+                creature->recorder = &recorder;
+                start = std::chrono::steady_clock::now();
+                for (int step = 0; step < steps; step++) {
+                    creature->timestep(delta);
+                }
+                recorded_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                creature->recorder = nullptr;
+                bytes += (long) recorder.size();
+            }
+            std::cout << "recording: " << recorded_seconds << " s, " << creature_steps / recorded_seconds
+                      << " creature steps/s, " << 100 * (recorded_seconds / scalar_seconds - 1)
+                      << "% over creatures, " << (double) bytes / (creature_steps + count) << " bytes per frame"
+                      << std::endl;
+        }
+
+        // Cost of stick constraints against their accuracy
+        std::vector<long> histogram;
+        double error = 0;
+        for (const auto &creature: creatures) {
+            histogram.resize(std::max(histogram.size(), creature->iteration_histogram.size()));
+            for (std::size_t i = 0; i < creature->iteration_histogram.size(); i++) {
+                histogram[i] += creature->iteration_histogram[i];
+            }
+            error = std::max(error, creature->stick_error());
+        }
+        auto print_histogram = [](const std::vector<long> &counts) {
+            double total = 0, sum = 0;
+            for (std::size_t i = 0; i < counts.size(); i++) {
+                total += (double) counts[i];
+                sum += (double) (i * counts[i]);
+                if (counts[i] > 0) std::cout << ' ' << i << ':' << counts[i];
+            }
+            std::cout << " (mean " << sum / total << ")" << std::endl;
+        };
+        std::cout << "sweeps per step, creatures:";
+        print_histogram(histogram);
+        std::cout << "sweeps per step, batch:    ";
+        print_histogram(batch.iteration_histogram);
+        std::cout << "largest final stick error " << error << std::endl;
+        return momentum_kept ? 0 : 1;
+    }
+
+    /**
+     * Record a creature to a file for replaying without simulating. With --archive, the creature is controlled by
+     * the best genome of --generation (the last one by default), otherwise it falls passively.
+     */
+    int record(const Options &options) {
+        const int steps = (int) options.get("steps", 500L);
+        const double delta = options.get("delta", 0.01);
+        const std::string output = options.get("output", std::string("neat.recording"));
+        Scenario scenario = options.contains("creature") ? CreatureFile::load(options.get("creature", std::string()))
+                                                         : Experiment::default_creature();
+        if (options.contains("terrain")) {
+            scenario.terrain = std::make_shared<const Terrain>(Terrain::generate(options.get("terrain", 1L)));
+        }
+        scenario.collision_radius = options.get("collision", 0.0);
+
+        std::unique_ptr<FastNetwork> network;
+        if (options.contains("archive")) {
+            Archive::Reader archive(options.get("archive", std::string()));
+            int position = options.contains("generation") ? archive.find((int) options.get("generation", 0L))
+                                                          : archive.size() - 1;
+            if (position < 0) {
+                throw std::runtime_error("Generation is not archived");
+            }
+            Population population(1, scenario.input_count(), scenario.output_count(),
+                                  [](std::vector<NetworkGenome> &) {}, 0);
+            network = std::make_unique<FastNetwork>(archive.best_genome(position, population));
+        }
+
+        auto creature = ScenarioSet::create_creature(scenario, network.get());
+        Recording::Writer recorder(output, (int) creature->points.size(), scenario.connections, delta, scenario.terrain.get(),
+                                   options.get("quantum", 1e-3));
+        recorder.record(creature->points);
+        creature->recorder = &recorder;
+        for (int step = 0; step < steps; step++) {
+            creature->timestep(delta);
+        }
+        creature->recorder = nullptr;
+
+        std::cout << "recorded " << steps + 1 << " frames to " << output << ", distance " << creature->distance_ran()
+                  << std::endl;
+        return 0;
+    }
+
+    /**
+     * Rank of each value (1 is the lowest), tied values get their average rank.
+     */
+    std::vector<double> ranks(const std::vector<double> &values) {
+        std::vector<int> order(values.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&values](int a, int b) { return values[a] < values[b]; });
+
+        std::vector<double> result(values.size());
+        for (std::size_t i = 0; i < order.size();) {
+            std::size_t j = i;
+            while (j + 1 < order.size() && values[order[j + 1]] == values[order[i]]) j++;
+            for (std::size_t k = i; k <= j; k++) {
+                result[order[k]] = (double) (i + j) / 2 + 1;
+            }
+            i = j + 1;
+        }
+        return result;
+    }
+
+    /**
+     * Spearman correlation of two samples, the Pearson correlation of their ranks.
+     */
+    double rank_correlation(const std::vector<double> &x, const std::vector<double> &y) {
+        std::vector<double> a = ranks(x), b = ranks(y);
+        const double mean = ((double) x.size() + 1) / 2;
+        double covariance = 0, variance_a = 0, variance_b = 0;
+        for (std::size_t i = 0; i < x.size(); i++) {
+            covariance += (a[i] - mean) * (b[i] - mean);
+            variance_a += (a[i] - mean) * (a[i] - mean);
+            variance_b += (b[i] - mean) * (b[i] - mean);
+        }
+        if (variance_a == 0 || variance_b == 0) return variance_a == variance_b ? 1 : 0;
+        return covariance / std::sqrt(variance_a * variance_b);
+    }
+
+    /**
+     * Simulate random poses of a creature in a batch and score them like Experiment::distance_run,
+     * without stopping early.
+     * @return fitness of each pose
+     */
+    template<typename Scalar>
+    std::vector<double> pose_fitness(const std::vector<Scenario> &poses, int steps, double delta, double &seconds) {
+        std::vector<std::unique_ptr<BasicCreature<Scalar>>> creatures;
+        for (const auto &pose: poses) {
+            creatures.push_back(ScenarioSet::create_creature<Scalar>(pose, nullptr));
+        }
+        BasicCreatureBatch<Scalar> batch(*creatures.front(), (int) poses.size());
+        for (int i = 0; i < (int) poses.size(); i++) {
+            batch.load(i, *creatures[i]);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int step = 0; step < steps; step++) {
+            batch.timestep((Scalar) delta);
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<double> fitness;
+        for (int i = 0; i < (int) poses.size(); i++) {
+            fitness.push_back(std::max(0.0, 1.0 + (double) batch.distance_ran(i)));
+        }
+        return fitness;
+    }
+
+    /**
+     * Simulate the same poses in float and double, then check that fitness rankings agree.
+     *
+     * Falling creatures are chaotic, so rankings drift apart over long episodes even between double runs.
+     * The float ranking is compared with a double run of poses rotated by float epsilon: it passes if its
+     * correlation with the double ranking is at most --margin below that of the perturbed double run.
+     */
+    int precision(const Options &options) {
+        const int count = (int) options.get("creatures", 200L);
+        const int steps = (int) options.get("steps", 500L);
+        const double delta = options.get("delta", 0.01);
+        const double margin = options.get("margin", 0.1);
+        Scenario scenario = options.contains("creature") ? CreatureFile::load(options.get("creature", std::string()))
+                          : options.contains("lattice") ? lattice((int) options.get("lattice", 2L))
+                                                        : Experiment::default_creature();
+
+        Random random((std::uint64_t) options.get("seed", 1L));
+        std::vector<Scenario> poses, perturbed_poses;
+        for (int i = 0; i < count; i++) {
+            scenario.rotation = random.uniform(-0.5, 0.5);
+            scenario.offset = Vector2D(0, random.uniform(0, 0.5));
+            poses.push_back(scenario);
+            scenario.rotation += std::numeric_limits<float>::epsilon();
+            perturbed_poses.push_back(scenario);
+        }
+
+        double double_seconds, float_seconds, perturbed_seconds;
+        std::vector<double> double_fitness = pose_fitness<double>(poses, steps, delta, double_seconds);
+        std::vector<double> float_fitness = pose_fitness<float>(poses, steps, delta, float_seconds);
+        std::vector<double> perturbed_fitness = pose_fitness<double>(perturbed_poses, steps, delta,
+                                                                     perturbed_seconds);
+
+        double difference = 0;
+        for (int i = 0; i < count; i++) {
+            difference = std::max(difference, std::abs(double_fitness[i] - float_fitness[i]));
+        }
+        const double float_correlation = rank_correlation(double_fitness, float_fitness);
+        const double perturbed_correlation = rank_correlation(double_fitness, perturbed_fitness);
+
+        std::cout << count << " poses, " << steps << " steps\n"
+                  << "double batch: " << double_seconds << " s, float batch: " << float_seconds << " s ("
+                  << double_seconds / float_seconds << "x)\n"
+                  << "largest fitness difference " << difference << "\n"
+                  << "rank correlation with double: float " << float_correlation << ", perturbed double "
+                  << perturbed_correlation << std::endl;
+        if (float_correlation < perturbed_correlation - margin) {
+            std::cerr << "Float rankings disagree with double more than chaos explains" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    void usage() {
+        std::cerr << "Usage: neat_cli <command> [--name value]...\n"
+                     "Commands:\n"
+                     "  evolve   evolve a population headlessly\n"
+                     "           --population 150 --generations 100 --seed <time> --threads <cores>\n"
+                     "           --steps 500 --delta 0.01 --creature <path> --checkpoint <path> --resume <path>\n"
+                     "           --archive <path> --terrains 0 --roughness 0.3 --collision 0 --surrogate 0\n"
+                     "           --batch 0\n"
+                     "  batch    run an experiment: hyperparameter sweep over seeds, results as a table\n"
+                     "           --config <path>, other options override its settings (see Experiment.h)\n"
+                     "           for example --seeds \"1 2 3\" --compatibility_threshold \"2 3 4\"\n"
+                     "  physics  benchmark creatures against a creature batch\n"
+                     "           --creatures 256 --steps 1000 --delta 0.01 --creature <path> --lattice <size>\n"
+                     "           --seed 1 --fast 0 --tolerance 0 --max_iterations 20 --networks 0 --terrain <seed>\n"
+                     "           --collision 0 --record <path>\n"
+                     "  record   record a creature for replaying in the viewer (neat --replay <path>)\n"
+                     "           --output neat.recording --archive <path> --generation <last> --creature <path>\n"
+                     "           --steps 500 --delta 0.01 --terrain <seed> --collision 0 --quantum 0.001\n"
+                     "  precision  check that float physics ranks creatures like double\n"
+                     "           --creatures 200 --steps 500 --delta 0.01 --creature <path> --lattice <size>\n"
+                     "           --seed 1 --margin 0.1\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    try {
+        std::string command = argv[1];
+        Options options(argc - 2, argv + 2);
+        if (command == "evolve") return evolve(options);
+        if (command == "batch") return batch(options);
+        if (command == "physics") return physics(options);
+        if (command == "precision") return precision(options);
+        if (command == "record") return record(options);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    usage();
+    return 1;
+}
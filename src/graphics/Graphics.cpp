@@ -1,7 +1,11 @@
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <iostream>
+#include <stdexcept>
 
 #include "Graphics.h"
+#include "../utils/Random.h"
 
 sf::Color Graphics::get_color(double weight) {
     if (weight == INFINITY) {
@@ -100,15 +104,15 @@ std::map<int, sf::Vector2f> Graphics::get_layered_positions(const GraphNetwork &
 
     const auto layers = network.get_layers();
 
-    std::default_random_engine engine(12345);
-    std::uniform_real_distribution<float> distribution(-50, 50);
+    Random random(12345);
 
     for (int i = 0; i < layers.size(); i++) {
         const std::vector<int> &current_layer = layers[i];
         float x = (float) width * (float) (i + 1) / (float) (layers.size() + 1);
 
         for (int j = 0; j < current_layer.size(); j++) {
-            float y = (float) height * (float) (j + 1) / (float) (current_layer.size() + 1) + distribution(engine);
+            float y = (float) height * (float) (j + 1) / (float) (current_layer.size() + 1) +
+                      (float) random.uniform(-50, 50);
 
             positions[layers[i][j]] = sf::Vector2f(x, y);
         }
@@ -117,6 +121,10 @@ std::map<int, sf::Vector2f> Graphics::get_layered_positions(const GraphNetwork &
     return positions;
 }
 
+sf::Vector2f Graphics::to_screen_space(const Vector2D &vector, int width, int height) {
+    return {(float) (1.0 * width / 2 + vector.x * 100), (float) (2.0 * height / 3 - vector.y * 100)};
+}
+
 void Graphics::simulate_creature(Creature &creature) {
     creature.normalise_position();
 
@@ -138,7 +146,7 @@ void Graphics::simulate_creature(Creature &creature) {
 
         for (const auto &point: creature.points) {
             sf::CircleShape p(4);
-            sf::Vector2f pos = point.position.to_screen_space(width, height);
+            sf::Vector2f pos = to_screen_space(point.position, width, height);
             pos.x -= 4;
             pos.y -= 4;
             p.setPosition(pos);
@@ -147,17 +155,27 @@ void Graphics::simulate_creature(Creature &creature) {
 
         for (const auto &stick: creature.sticks) {
             sf::Vertex vertices[] = {
-                    {stick.ends[0]->position.to_screen_space(width, height), sf::Color::White},
-                    {stick.ends[1]->position.to_screen_space(width, height), sf::Color::White}
+                    {to_screen_space(stick.ends[0]->position, width, height), sf::Color::White},
+                    {to_screen_space(stick.ends[1]->position, width, height), sf::Color::White}
             };
 
             window.draw(vertices, 2, sf::Lines);
         }
-        sf::Vertex ground[] = {
-                sf::Vertex({0, (float) (2.0 * height / 3)}),
-                sf::Vertex({(float) width, (float) (2.0 * height / 3)})
-        };
-        window.draw(ground, 2, sf::Lines);
+        if (creature.terrain == nullptr) {
+            sf::Vertex ground[] = {
+                    sf::Vertex({0, (float) (2.0 * height / 3)}),
+                    sf::Vertex({(float) width, (float) (2.0 * height / 3)})
+            };
+            window.draw(ground, 2, sf::Lines);
+        } else {
+            // A vertex every 10 pixels, the same scale as to_screen_space
+            std::vector<sf::Vertex> ground;
+            for (int x = 0; x <= width; x += 10) {
+                double world_x = (x - width / 2.0) / 100;
+                ground.emplace_back(to_screen_space({world_x, creature.terrain->height(world_x)}, width, height));
+            }
+            window.draw(ground.data(), ground.size(), sf::LineStrip);
+        }
 
         window.display();
 
@@ -167,6 +185,135 @@ void Graphics::simulate_creature(Creature &creature) {
     }
 }
 
+void Graphics::replay(const std::string &path) {
+    Recording::Reader recording(path);
+    const long frame_count = recording.frame_count();
+    if (frame_count == 0) {
+        throw std::runtime_error("Recording has no frames: " + path);
+    }
+    const double delta = recording.header->delta;
+
+    sf::RenderWindow window(sf::VideoMode(640, 480), "Replay " + path);
+    sf::Font font;
+    font.loadFromFile("/usr/share/fonts/truetype/liberation/LiberationMono-Regular.ttf");
+
+    // Playback position in frames, advanced by real time
+    double position = 0;
+    double speed = 1;
+    bool paused = false;
+    sf::Clock clock;
+    std::vector<Vector2D> points;
+    while (window.isOpen()) {
+        const int width = (int) window.getSize().x;
+        const int height = (int) window.getSize().y;
+        const float timeline = (float) height - 10;
+
+        sf::Event event{};
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+            } else if (event.type == sf::Event::KeyPressed) {
+                switch (event.key.code) {
+                    case sf::Keyboard::Space:
+                        paused = !paused;
+                        break;
+                    case sf::Keyboard::Left:
+                        position -= 1 / delta;
+                        break;
+                    case sf::Keyboard::Right:
+                        position += 1 / delta;
+                        break;
+                    case sf::Keyboard::Up:
+                        speed *= 2;
+                        break;
+                    case sf::Keyboard::Down:
+                        speed /= 2;
+                        break;
+                    case sf::Keyboard::Home:
+                        position = 0;
+                        break;
+                    default:
+                        break;
+                }
+            } else if (event.type == sf::Event::MouseButtonPressed && (float) event.mouseButton.y >= timeline - 10) {
+                position = (double) event.mouseButton.x / width * (double) frame_count;
+            }
+        }
+
+        double elapsed = clock.restart().asSeconds();
+        if (!paused) position += elapsed * speed / delta;
+        position = std::clamp(position, 0.0, (double) (frame_count - 1));
+        const long frame = (long) position;
+        recording.frame(frame, points);
+
+        // Camera follows the centre of the creature horizontally
+        double camera = 0;
+        for (const auto &point: points) {
+            camera += point.x;
+        }
+        camera /= (double) points.size();
+        if (!std::isfinite(camera)) camera = 0;
+        const Vector2D shift(camera, 0);
+
+        window.clear();
+
+        for (const auto &point: points) {
+            sf::CircleShape p(4);
+            sf::Vector2f pos = to_screen_space(point - shift, width, height);
+            pos.x -= 4;
+            pos.y -= 4;
+            p.setPosition(pos);
+            window.draw(p);
+        }
+
+        for (const auto &[first, second]: recording.sticks) {
+            sf::Vertex vertices[] = {
+                    {to_screen_space(points[first] - shift, width, height), sf::Color::White},
+                    {to_screen_space(points[second] - shift, width, height), sf::Color::White}
+            };
+
+            window.draw(vertices, 2, sf::Lines);
+        }
+
+        if (recording.terrain == nullptr) {
+            sf::Vertex ground[] = {
+                    sf::Vertex({0, (float) (2.0 * height / 3)}),
+                    sf::Vertex({(float) width, (float) (2.0 * height / 3)})
+            };
+            window.draw(ground, 2, sf::Lines);
+        } else {
+            // A vertex every 10 pixels, the same scale as to_screen_space
+            std::vector<sf::Vertex> ground;
+            for (int x = 0; x <= width; x += 10) {
+                double world_x = (x - width / 2.0) / 100;
+                double ground_height = recording.terrain->height(world_x + camera);
+                ground.emplace_back(to_screen_space({world_x, ground_height}, width, height));
+            }
+            window.draw(ground.data(), ground.size(), sf::LineStrip);
+        }
+
+        // Timeline with the current moment
+        sf::Vertex line[] = {
+                sf::Vertex({0, timeline}, sf::Color(128, 128, 128)),
+                sf::Vertex({(float) width, timeline}, sf::Color(128, 128, 128))
+        };
+        window.draw(line, 2, sf::Lines);
+        sf::RectangleShape marker({3, 12});
+        marker.setPosition((float) ((double) frame / (double) frame_count * width) - 1, timeline - 6);
+        window.draw(marker);
+
+        std::stringstream ss;
+        ss << frame * delta << " s / " << (double) frame_count * delta << " s, " << speed << "x"
+           << (paused ? ", paused" : "");
+        sf::Text text(ss.str(), font, 14);
+        text.setPosition(5, 5);
+        window.draw(text);
+
+        window.display();
+        sf::sleep(sf::milliseconds(10));
+    }
+}
+
 std::pair<std::vector<Vector2D>, std::vector<std::pair<int, int>>> Graphics::create_creature() {
     sf::RenderWindow window(sf::VideoMode(640, 480), "Draw creature");
 
@@ -5,6 +5,7 @@
 
 #include "../utils/GraphNetwork.h"
 #include "../simulation/Creature.h"
+#include "../simulation/Recording.h"
 
 /**
  * Class for all graphics related stuff.
@@ -34,8 +35,25 @@ public:
      */
     static std::map<int, sf::Vector2f> get_layered_positions(const GraphNetwork& network, int width, int height);
 
+    /**
+     * Convert a simulation position to a window position.
+     * @param vector position in the simulation
+     * @param width width of the window
+     * @param height height of the window
+     * @return position in the window
+     */
+    static sf::Vector2f to_screen_space(const Vector2D &vector, int width, int height);
+
     static void simulate_creature(Creature &creature);
 
+    /**
+     * Play a recording (see Recording) in a window, following the creature, without simulating it.
+     * Space pauses, left and right arrows skip a second back and forth, up and down arrows double and halve
+     * the speed, Home restarts, clicking the timeline at the bottom jumps to that moment.
+     * @param path path to the recording
+     */
+    static void replay(const std::string &path);
+
     static std::pair<std::vector<Vector2D>, std::vector<std::pair<int, int>>> create_creature();
 };
 
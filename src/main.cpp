@@ -1,47 +1,113 @@
 #include <iostream>
 
 #include "neat/Population.h"
+#include "neat/Checkpoint.h"
+#include "neat/Archive.h"
+#include "neat/SuccessiveHalving.h"
 #include "graphics/Graphics.h"
 #include "utils/FastNetwork.h"
+#include "simulation/CreatureFile.h"
+#include "simulation/Episode.h"
+#include "simulation/Recording.h"
+#include "simulation/ScenarioSet.h"
+#include "utils/ThreadPool.h"
 
-#include <thread>
+#include <limits>
+#include <memory>
+#include <string>
+
+int main(int argc, char **argv) {
+    // Watch a recording (neat_cli record) instead of evolving
+    if (argc > 1 && std::string(argv[1]) == "--replay") {
+        if (argc < 3) {
+            std::cerr << "Usage: neat [checkpoint] | neat --replay <recording>" << std::endl;
+            return 1;
+        }
+        Graphics::replay(argv[2]);
+        return 0;
+    }
 
-int main() {
     auto p = Graphics::create_creature();
+    // Keep the drawn creature for headless runs (neat_cli evolve --creature neat.creature)
+    CreatureFile::save({p.first, p.second}, "neat.creature");
     Creature preview(p.first, p.second);
     Graphics::simulate_creature(preview);
 
-    auto eval = [&p](std::vector<NetworkGenome> &genomes) {
-        std::vector<std::thread> threads;
-        threads.reserve(genomes.size());
-        for (auto &genome: genomes) {
-            threads.emplace_back([&p](NetworkGenome *genome) {
-                Creature creature(p.first, p.second, FastNetwork(*genome));
-                for (int i = 0; i < 500; i++) {
-                    creature.timestep(0.01);
-                }
-                genome->fitness = std::max(0.0, 1.0 + creature.distance_ran());
-//                genome->fitness = creature.highest_jump;
-            }, &genome);
+    EpisodeController episodes;
+    Fidelity fidelity{};
+    // Fitness is derived from objectives, so there is no cutoff on distance
+    auto run = [&episodes, &fidelity](Creature &creature, const Scenario &, double, double *objectives) {
+        creature.constraint_iterations = fidelity.constraint_iterations;
+        Episode episode = episodes.start(-std::numeric_limits<double>::infinity(), fidelity.steps);
+        do {
+            creature.timestep(fidelity.delta);
+        } while (episode.report(creature));
 
+        if (episode.reason == StopReason::Exploded) {
+            // Failed evaluation, worse than any other (see Population::pareto_fitness)
+            objectives[0] = objectives[1] = objectives[2] = std::numeric_limits<double>::quiet_NaN();
+        } else {
+            objectives[0] = creature.distance_ran();
+            objectives[1] = creature.highest_jump;
+            objectives[2] = -creature.energy_spent;
         }
-        for(auto& thread : threads) {
-            thread.join();
-        }
     };
 
-    Population population(150, (int)p.first.size() + 1, 1,
-                          std::function<void(std::vector<NetworkGenome> &)>(eval));
-    for (int i = 0; i < 100; i++) {
-        std::cout << i << ": " << population.best_fitness << ", " << population.average_fitness << ", "
-                  << population.species.size() << std::endl;
-        population.evolution_step();
+    // The drawn creature starting upright, tilted both ways, dropped from above and on hills
+    std::vector<Scenario> scenarios;
+    for (auto [rotation, drop]: std::vector<std::pair<double, double>>{{0, 0}, {-0.3, 0}, {0.3, 0}, {0, 0.5}}) {
+        scenarios.push_back({p.first, p.second, {}, rotation, Vector2D(0, drop)});
+    }
+    scenarios.push_back({p.first, p.second, {}, 0, Vector2D(), std::make_shared<const Terrain>(Terrain::generate(1))});
+    ThreadPool pool;
+    ScenarioSet scenario_set(scenarios, pool, run, 3);
+
+    auto simulate = [&scenario_set, &fidelity](std::vector<NetworkGenome *> &genomes, const Fidelity &f) {
+        fidelity = f;
+        scenario_set.evaluate(genomes);
+    };
+
+    // Every fidelity simulates 5 seconds
+    SuccessiveHalving scheduler({{100, 0.05, 2}, {250, 0.02, 3}, {500, 0.01, 5}}, simulate);
+    std::function<void(std::vector<NetworkGenome> &)> eval = std::ref(scheduler);
+
+    // Resume from a checkpoint if one is given
+    std::unique_ptr<Population> population;
+    if (argc > 1) {
+        population = Checkpoint::load(argv[1], eval);
+    } else {
+        population = std::make_unique<Population>(150, scenarios.front().input_count(),
+                                                  scenarios.front().output_count(), eval);
     }
-    Creature creature(p.first, p.second, FastNetwork(*population.best));
 
-    while (true) {
-        Graphics::simulate_creature(creature);
+    Checkpoint::Writer checkpoint;
+    Archive::Writer archive("neat.archive", population->generation);
+    while (population->generation < 100) {
+        std::cout << population->generation << ": " << population->best_fitness << ", "
+                  << population->average_fitness << ", " << population->species.size() << ", stopped early: "
+                  << episodes.count(StopReason::Stalled) << " stalled, "
+                  << episodes.count(StopReason::Exploded) << " exploded" << std::endl;
+        archive.append(*population);
+        population->evolution_step();
+
+        if (population->generation % 10 == 0) {
+            checkpoint.save(*population, "neat.checkpoint");
+        }
+    }
+    checkpoint.wait();
+
+    // Record 30 seconds of the champion once, then replay it at any speed (neat --replay neat.recording)
+    Creature creature(p.first, p.second, FastNetwork(*population->best));
+    {
+        Recording::Writer recorder("neat.recording", (int) creature.points.size(), p.second, 0.01);
+        recorder.record(creature.points);
+        creature.recorder = &recorder;
+        for (int step = 0; step < 3000; step++) {
+            creature.timestep(0.01);
+        }
+        creature.recorder = nullptr;
     }
+    Graphics::replay("neat.recording");
 
     std::cout << "Dobra zmiana" << std::endl;
 
@@ -0,0 +1,300 @@
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#include "Archive.h"
+#include "GenomeCodec.h"
+
+static const char file_magic[8] = {'N', 'E', 'A', 'T', 'A', 'R', 'C', 'H'};
+static const char segment_magic[4] = {'S', 'E', 'G', 'M'};
+
+std::vector<std::uint8_t> Archive::encode_segment(const Population &population) {
+    const auto &genomes = population.genomes;
+
+    // Species of every genome
+    std::vector<std::uint32_t> species(genomes.size(), 0);
+    for (int s = 0; s < (int) population.species.size(); s++) {
+        for (int index: population.species[s].genomes) {
+            species[index] = s;
+        }
+    }
+
+    std::vector<std::uint8_t> payload;
+    ByteWriter writer(payload);
+    std::vector<Record> records;
+    records.reserve(genomes.size());
+    for (int i = 0; i < (int) genomes.size(); i++) {
+        const NetworkGenome &genome = genomes[i];
+        std::size_t offset = payload.size();
+        GenomeCodec::encode(genome, writer);
+
+        records.push_back({genome.id, {genome.parents[0], genome.parents[1]}, genome.fitness, genome.raw_fitness,
+                           species[i], (std::uint32_t) genome.genome.size(), offset, payload.size() - offset});
+    }
+
+    // Keep the next segment aligned
+    payload.resize((payload.size() + 7) / 8 * 8);
+
+    bool best_in_generation = population.best >= genomes.data() && population.best < genomes.data() + genomes.size();
+    SegmentHeader header{};
+    std::memcpy(header.magic, segment_magic, sizeof(segment_magic));
+    header.genome_count = genomes.size();
+    header.generation = population.generation;
+    header.payload_size = payload.size();
+    header.best = best_in_generation ? population.best - genomes.data() : -1;
+    header.best_fitness = population.best_fitness;
+    header.average_fitness = population.average_fitness;
+
+    std::vector<std::uint8_t> segment;
+    segment.reserve(sizeof(header) + records.size() * sizeof(Record) + payload.size());
+    ByteWriter segment_writer(segment);
+    segment_writer.write_bytes(&header, sizeof(header));
+    segment_writer.write_bytes(records.data(), records.size() * sizeof(Record));
+    segment_writer.write_bytes(payload.data(), payload.size());
+    return segment;
+}
+
+Archive::Writer::Writer(const std::string &path, long first_generation) {
+    const std::string index_path = path + ".index";
+
+    // Keep complete segments of earlier generations, anything after them is dropped
+    std::uintmax_t data_size = 0;
+    std::uintmax_t index_size = 0;
+    std::error_code exists_error;
+    if (first_generation > 0 && std::filesystem::exists(path, exists_error)) {
+        Reader reader(path);
+        int kept = 0;
+        while (kept < reader.size() && (long) reader.entry(kept).generation < first_generation) kept++;
+        if (kept > 0) {
+            const IndexEntry &last = reader.entry(kept - 1);
+            data_size = last.offset + last.size;
+            index_size = kept * sizeof(IndexEntry);
+        }
+    }
+
+    if (data_size == 0) {
+        // A new file rather than truncating the old one, which readers may have mapped
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        std::filesystem::remove(index_path, error);
+    } else {
+        std::filesystem::resize_file(path, data_size);
+        std::filesystem::resize_file(index_path, index_size);
+    }
+
+    data = std::fopen(path.c_str(), "ab");
+    if (data == nullptr) {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+    index = std::fopen(index_path.c_str(), "ab");
+    if (index == nullptr) {
+        int error = errno;
+        std::fclose(data);
+        throw std::system_error(error, std::generic_category(), index_path);
+    }
+
+    // New archive
+    std::fseek(data, 0, SEEK_END);
+    if (std::ftell(data) == 0) {
+        FileHeader header{};
+        std::memcpy(header.magic, file_magic, sizeof(file_magic));
+        header.version = version;
+        if (std::fwrite(&header, sizeof(header), 1, data) != 1 || std::fflush(data) != 0) {
+            int error = errno;
+            std::fclose(data);
+            std::fclose(index);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+    }
+
+    thread = std::thread(&Writer::write, this);
+}
+
+Archive::Writer::~Writer() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+
+    std::fclose(data);
+    std::fclose(index);
+}
+
+void Archive::Writer::append(const Population &population) {
+    auto segment = encode_segment(population);
+
+    std::lock_guard lock(mutex);
+    if (error) std::rethrow_exception(error);
+    queue.push_back(std::move(segment));
+    changed.notify_all();
+}
+
+void Archive::Writer::flush() {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [this] { return queue.empty(); });
+    if (error) std::rethrow_exception(error);
+}
+
+void Archive::Writer::write() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) return;
+
+        // Segment stays queued until written, so flush waits for it
+        const auto &segment = queue.front();
+        lock.unlock();
+
+        std::fseek(data, 0, SEEK_END);
+        IndexEntry entry{};
+        std::memcpy(&entry.generation, segment.data() + offsetof(SegmentHeader, generation), sizeof(entry.generation));
+        entry.offset = std::ftell(data);
+        entry.size = segment.size();
+
+        // Index entry is written only after the whole segment
+        bool written = std::fwrite(segment.data(), 1, segment.size(), data) == segment.size() &&
+                       std::fflush(data) == 0 &&
+                       std::fwrite(&entry, sizeof(entry), 1, index) == 1 &&
+                       std::fflush(index) == 0;
+        int write_error = errno;
+
+        lock.lock();
+        if (!written) {
+            // Later segments are dropped, the index must not skip a generation
+            error = std::make_exception_ptr(std::system_error(write_error, std::generic_category(), "archive"));
+            queue.clear();
+        } else {
+            queue.pop_front();
+        }
+        changed.notify_all();
+    }
+}
+
+Archive::Reader::Reader(const std::string &path) : data(path), index(path + ".index") {
+    if (data.size() < sizeof(FileHeader) ||
+        std::memcmp(((const FileHeader *) data.data())->magic, file_magic, sizeof(file_magic)) != 0) {
+        throw std::runtime_error("Not an archive: " + path);
+    }
+    if (((const FileHeader *) data.data())->version != version) {
+        throw std::runtime_error("Unsupported archive version: " + path);
+    }
+
+    // Ignore a segment that was being written when the archive was opened
+    int entries = (int) (index.size() / sizeof(IndexEntry));
+    while (count < entries) {
+        const IndexEntry &e = entry(count);
+        if (e.offset + e.size > data.size() || e.size < sizeof(SegmentHeader)) break;
+
+        const SegmentHeader &header = segment(count);
+        if (std::memcmp(header.magic, segment_magic, sizeof(segment_magic)) != 0 ||
+            sizeof(SegmentHeader) + header.genome_count * sizeof(Record) + header.payload_size != e.size) {
+            throw std::runtime_error("Malformed archive: " + path);
+        }
+        count++;
+    }
+}
+
+const Archive::IndexEntry &Archive::Reader::entry(int position) const {
+    return ((const IndexEntry *) index.data())[position];
+}
+
+int Archive::Reader::size() const {
+    return count;
+}
+
+int Archive::Reader::find(int generation) const {
+    // Generations are appended in increasing order
+    int low = 0;
+    int high = count - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        auto g = (long) entry(middle).generation;
+        if (g == generation) return middle;
+        if (g < generation) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return -1;
+}
+
+const Archive::SegmentHeader &Archive::Reader::segment(int position) const {
+    return *(const SegmentHeader *) (data.data() + entry(position).offset);
+}
+
+const Archive::Record *Archive::Reader::records(int position) const {
+    return (const Record *) (data.data() + entry(position).offset + sizeof(SegmentHeader));
+}
+
+NetworkGenome Archive::Reader::genome(int position, int record, Population &population) const {
+    const SegmentHeader &header = segment(position);
+    const Record &r = records(position)[record];
+    const std::uint8_t *payload = (const std::uint8_t *) (records(position) + header.genome_count);
+    if (r.offset + r.size > header.payload_size) {
+        throw std::runtime_error("Malformed archive record");
+    }
+
+    ByteReader reader(payload + r.offset, r.size);
+    return GenomeCodec::decode(reader, population);
+}
+
+NetworkGenome Archive::Reader::best_genome(int position, Population &population) const {
+    const SegmentHeader &header = segment(position);
+    int best = (int) header.best;
+    if (best < 0) {
+        // Best wasn't known when archiving, search records
+        const Record *r = records(position);
+        best = 0;
+        for (int i = 1; i < (int) header.genome_count; i++) {
+            if (r[i].raw_fitness > r[best].raw_fitness) best = i;
+        }
+    }
+    return genome(position, best, population);
+}
+
+std::vector<double> Archive::Reader::fitness_distribution(int position) const {
+    const Record *r = records(position);
+    std::vector<double> fitness(segment(position).genome_count);
+    for (int i = 0; i < (int) fitness.size(); i++) {
+        fitness[i] = r[i].raw_fitness;
+    }
+    return fitness;
+}
+
+int Archive::Reader::find_record(long id, int position) const {
+    const Record *r = records(position);
+    for (int i = 0; i < (int) segment(position).genome_count; i++) {
+        if (r[i].id == id) return i;
+    }
+    return -1;
+}
+
+std::vector<std::pair<int, int>> Archive::Reader::lineage(long id, int position) const {
+    std::vector<std::pair<int, int>> ancestors;
+    int record = find_record(id, position);
+    while (record != -1) {
+        ancestors.emplace_back(position, record);
+
+        // Ancestors can only be found in the directly preceding generation
+        int previous = position - 1;
+        if (previous < 0 || entry(previous).generation + 1 != entry(position).generation) break;
+
+        // Genome copied unchanged from the previous generation keeps its id
+        int survivor = find_record(id, previous);
+        if (survivor == -1) {
+            id = records(position)[record].parents[0];
+            if (id == -1) break;
+            survivor = find_record(id, previous);
+        }
+
+        position = previous;
+        record = survivor;
+    }
+    return ancestors;
+}
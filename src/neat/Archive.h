@@ -0,0 +1,218 @@
+#ifndef NEAT_ARCHIVE_H
+#define NEAT_ARCHIVE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Population.h"
+#include "../utils/MappedFile.h"
+
+/**
+ * Append-only archive of every generation of a run.
+ *
+ * The data file starts with a file header, followed by one segment per archived generation.
+ * A segment is a SegmentHeader, a table of fixed size Records (one per genome, in population order)
+ * and genes of all genomes encoded by GenomeCodec. Segments are padded to 8 bytes.
+ * A separate index file (path + ".index") holds an IndexEntry per segment, written only after the segment itself,
+ * so the index never points at incomplete data.
+ *
+ * All structures are fixed layout, so a Reader works directly on a memory mapping and answers queries
+ * by touching only the segments (and usually only the record tables) involved.
+ */
+class Archive {
+public:
+    static constexpr std::uint32_t version = 2;
+
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+    };
+
+    struct SegmentHeader {
+        char magic[4];
+        std::uint32_t genome_count;
+        std::uint64_t generation;
+        std::uint64_t payload_size;  /// size of encoded genes (including padding)
+        std::int64_t best;           /// index of the best genome, -1 if unknown
+        double best_fitness;
+        double average_fitness;
+    };
+
+    struct Record {
+        std::int64_t id;
+        std::int64_t parents[2];
+        double fitness;              /// fitness after sharing
+        double raw_fitness;
+        std::uint32_t species;       /// index of the species in the generation
+        std::uint32_t gene_count;
+        std::uint64_t offset;        /// offset of the encoded genome in the payload
+        std::uint64_t size;          /// size of the encoded genome
+    };
+
+    struct IndexEntry {
+        std::uint64_t generation;
+        std::uint64_t offset;        /// offset of the segment in the data file
+        std::uint64_t size;          /// size of the whole segment
+    };
+
+    static_assert(sizeof(FileHeader) == 16);
+    static_assert(sizeof(SegmentHeader) == 48);
+    static_assert(sizeof(Record) == 64);
+    static_assert(sizeof(IndexEntry) == 24);
+
+    /**
+     * Encode a generation as a segment.
+     * @param population population containing the generation
+     * @return encoded segment
+     */
+    static std::vector<std::uint8_t> encode_segment(const Population &population);
+
+    /**
+     * Appends generations to an archive from a background thread.
+     * Generations are encoded by the calling thread, so the population may change right after append returns.
+     */
+    class Writer {
+    private:
+        std::FILE *data;
+        std::FILE *index;
+
+        std::deque<std::vector<std::uint8_t>> queue;
+        std::mutex mutex;
+        std::condition_variable changed;
+        bool stopping = false;
+        std::thread thread;
+
+        /**
+         * Error of a failed write. Nothing is written after it, so the archive stays consistent.
+         */
+        std::exception_ptr error;
+
+        /**
+         * Loop writing queued segments.
+         */
+        void write();
+
+    public:
+        /**
+         * Open an archive for appending generations from first_generation on.
+         * A new run (first_generation 0) replaces an existing archive with a new file (readers of it keep the old
+         * content). A resumed run keeps the archived generations before first_generation and truncates the rest,
+         * so generations stay in increasing order. Readers of a truncated archive must be opened again.
+         * Throws std::system_error if files can't be opened or truncated, or std::runtime_error if the archive
+         * to keep is malformed.
+         * @param path path to the data file
+         * @param first_generation generation appended first
+         */
+        explicit Writer(const std::string &path, long first_generation = 0);
+
+        Writer(const Writer &) = delete;
+
+        Writer &operator=(const Writer &) = delete;
+
+        /**
+         * Write all queued generations and close the archive.
+         */
+        ~Writer();
+
+        /**
+         * Queue the current generation of a population for writing. Rethrows an error of an earlier write.
+         * @param population population containing the generation
+         */
+        void append(const Population &population);
+
+        /**
+         * Wait until all queued generations are written. Rethrows an error of writing.
+         */
+        void flush();
+    };
+
+    /**
+     * Reads an archive through memory mappings. Sees generations written before it was created.
+     */
+    class Reader {
+    private:
+        friend class Writer;
+
+        MappedFile data;
+        MappedFile index;
+
+        /**
+         * Number of complete segments.
+         */
+        int count = 0;
+
+        [[nodiscard]] const IndexEntry &entry(int position) const;
+
+    public:
+        /**
+         * Open an archive. Throws std::system_error if files can't be mapped or std::runtime_error if they are malformed.
+         * @param path path to the data file
+         */
+        explicit Reader(const std::string &path);
+
+        /**
+         * @return number of archived generations
+         */
+        [[nodiscard]] int size() const;
+
+        /**
+         * Find position of a generation in the archive.
+         * @param generation generation number
+         * @return position or -1 if the generation isn't archived
+         */
+        [[nodiscard]] int find(int generation) const;
+
+        [[nodiscard]] const SegmentHeader &segment(int position) const;
+
+        /**
+         * @param position position of the generation
+         * @return pointer to segment(position).genome_count records
+         */
+        [[nodiscard]] const Record *records(int position) const;
+
+        /**
+         * Decode a genome.
+         * @param position position of the generation
+         * @param record index of the genome in the generation
+         * @param population population the genome is decoded into
+         * @return decoded genome (allocated from the default resource)
+         */
+        [[nodiscard]] NetworkGenome genome(int position, int record, Population &population) const;
+
+        /**
+         * Decode the best genome of a generation.
+         */
+        [[nodiscard]] NetworkGenome best_genome(int position, Population &population) const;
+
+        /**
+         * Get raw fitness of every genome of a generation.
+         */
+        [[nodiscard]] std::vector<double> fitness_distribution(int position) const;
+
+        /**
+         * Trace ancestors of a genome through first parents, back to the oldest archived generation.
+         * @param id id of the genome
+         * @param position position of a generation containing the genome
+         * @return pairs of (position, record index), starting with the genome itself
+         */
+        [[nodiscard]] std::vector<std::pair<int, int>> lineage(long id, int position) const;
+
+        /**
+         * Find a genome in a generation by id.
+         * @return index of its record or -1
+         */
+        [[nodiscard]] int find_record(long id, int position) const;
+    };
+};
+
+
+#endif //NEAT_ARCHIVE_H
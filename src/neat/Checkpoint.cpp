@@ -0,0 +1,243 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "Checkpoint.h"
+#include "GenomeCodec.h"
+
+static const char magic[8] = {'N', 'E', 'A', 'T', 'C', 'K', 'P', 'T'};
+
+std::vector<std::uint8_t> Checkpoint::encode(const Population &population) {
+    std::vector<std::uint8_t> data;
+    ByteWriter writer(data);
+    writer.write_bytes(magic, sizeof(magic));
+    writer.write_varint(version);
+
+    // Hyperparameters
+    writer.write_varint(population.size);
+    writer.write_double(population.enable_gene_chance);
+    writer.write_double(population.weight_mutation_chance);
+    writer.write_double(population.set_weight_chance);
+    writer.write_double(population.add_node_mutation_chance);
+    writer.write_double(population.add_connection_mutation_chance);
+    writer.write_double(population.non_crossover_breeding_rate);
+    writer.write_double(population.selection_rate);
+    writer.write_varint((int) population.selection_method);
+    writer.write_varint(population.tournament_size);
+    writer.write_double(population.compatibility_threshold);
+    writer.write_double(population.c1);
+    writer.write_double(population.c2);
+    writer.write_double(population.c3);
+
+    // Statistics
+    const auto &genomes = population.genomes;
+    bool best_in_generation = population.best >= genomes.data() && population.best < genomes.data() + genomes.size();
+    writer.write_signed(best_in_generation ? population.best - genomes.data() : -1);
+    writer.write_double(population.best_fitness);
+    writer.write_double(population.average_fitness);
+    writer.write_varint(population.generation);
+    writer.write_varint(population.next_genome_id);
+
+    // Innovations
+    writer.write_varint(population.innovation_number);
+    writer.write_varint(population.innovations.size());
+    for (const auto &innovation: population.innovations) {
+        writer.write_varint(innovation.in);
+        writer.write_varint(innovation.out);
+        writer.write_varint(innovation.innovation);
+    }
+
+    // Random generator
+    std::stringstream random_state;
+    random_state << population.random_generator;
+    writer.write_string(random_state.str());
+
+    // Genomes
+    writer.write_varint(genomes.size());
+    for (const auto &genome: genomes) {
+        GenomeCodec::encode(genome, writer);
+    }
+
+    // Species
+    writer.write_varint(population.species.size());
+    for (const auto &s: population.species) {
+        GenomeCodec::encode(*s.representative, writer);
+        writer.write_double(s.fitness);
+        writer.write_double(s.max_fitness);
+        writer.write_signed(s.generations_left);
+        writer.write_double(s.survival_cutoff);
+        writer.write_varint(s.genomes.size());
+        for (int index: s.genomes) {
+            writer.write_varint(index);
+        }
+    }
+
+    return data;
+}
+
+std::unique_ptr<Population> Checkpoint::decode(const std::uint8_t *data, std::size_t size,
+                                               std::function<void(std::vector<NetworkGenome> &)> evaluation) {
+    ByteReader reader(data, size);
+    char file_magic[sizeof(magic)];
+    reader.read_bytes(file_magic, sizeof(file_magic));
+    if (std::memcmp(file_magic, magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a checkpoint");
+    }
+    if (reader.read_varint() != version) {
+        throw std::runtime_error("Unsupported checkpoint version");
+    }
+
+    // Population can't be made bigger than the data could describe
+    auto population_size = reader.read_varint();
+    if (population_size > size) {
+        throw std::runtime_error("Malformed checkpoint");
+    }
+    std::unique_ptr<Population> population(new Population((int) population_size, std::move(evaluation)));
+    Population &p = *population;
+
+    p.enable_gene_chance = reader.read_double();
+    p.weight_mutation_chance = reader.read_double();
+    p.set_weight_chance = reader.read_double();
+    p.add_node_mutation_chance = reader.read_double();
+    p.add_connection_mutation_chance = reader.read_double();
+    p.non_crossover_breeding_rate = reader.read_double();
+    p.selection_rate = reader.read_double();
+    p.selection_method = (SelectionMethod) reader.read_varint();
+    p.tournament_size = (int) reader.read_varint();
+    p.compatibility_threshold = reader.read_double();
+    p.c1 = reader.read_double();
+    p.c2 = reader.read_double();
+    p.c3 = reader.read_double();
+
+    auto best = reader.read_signed();
+    p.best_fitness = reader.read_double();
+    p.average_fitness = reader.read_double();
+    p.generation = (int) reader.read_varint();
+    p.next_genome_id = (long) reader.read_varint();
+
+    p.innovation_number = (int) reader.read_varint();
+    auto innovation_count = reader.read_varint();
+    if (innovation_count > reader.remaining()) {
+        throw std::runtime_error("Malformed checkpoint");
+    }
+    p.innovations.reserve(innovation_count);
+    for (std::size_t i = 0; i < innovation_count; i++) {
+        int in = (int) reader.read_varint();
+        int out = (int) reader.read_varint();
+        int innovation = (int) reader.read_varint();
+        p.innovations.emplace_back(in, out, innovation, false, 0);
+    }
+
+    std::stringstream random_state(reader.read_string());
+    random_state >> p.random_generator;
+
+    auto genome_count = reader.read_varint();
+    if (genome_count > reader.remaining()) {
+        throw std::runtime_error("Malformed checkpoint");
+    }
+    for (std::size_t i = 0; i < genome_count; i++) {
+        p.genomes.push_back(GenomeCodec::decode(reader, p, p.arena));
+    }
+    if (best >= (std::int64_t) p.genomes.size()) {
+        throw std::runtime_error("Malformed checkpoint");
+    }
+    p.best = best >= 0 ? &p.genomes[best] : nullptr;
+
+    auto species_count = reader.read_varint();
+    if (species_count > reader.remaining()) {
+        throw std::runtime_error("Malformed checkpoint");
+    }
+    p.species.reserve(species_count);
+    for (std::size_t i = 0; i < species_count; i++) {
+        NetworkGenome representative = GenomeCodec::decode(reader, p);
+        double fitness = reader.read_double();
+        double max_fitness = reader.read_double();
+        int generations_left = (int) reader.read_signed();
+        double survival_cutoff = reader.read_double();
+
+        auto member_count = reader.read_varint();
+        if (member_count == 0 || member_count > p.genomes.size()) {
+            throw std::runtime_error("Malformed checkpoint");
+        }
+        std::vector<int> members;
+        for (std::size_t j = 0; j < member_count; j++) {
+            auto index = reader.read_varint();
+            if (index >= p.genomes.size()) {
+                throw std::runtime_error("Malformed checkpoint");
+            }
+            members.push_back((int) index);
+        }
+
+        Species &s = p.species.emplace_back(p, members.front());
+        *s.representative = representative;
+        s.genomes = std::move(members);
+        s.fitness = fitness;
+        s.max_fitness = max_fitness;
+        s.generations_left = generations_left;
+        s.survival_cutoff = survival_cutoff;
+    }
+
+    p.genome_species.assign(p.genomes.size(), -1);
+    for (int i = 0; i < (int) p.species.size(); i++) {
+        for (int index: p.species[i].genomes) {
+            p.genome_species[index] = i;
+        }
+    }
+
+    return population;
+}
+
+void Checkpoint::write_file(const std::string &path, const std::vector<std::uint8_t> &data) {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write((const char *) data.data(), (std::streamsize) data.size());
+        if (!file) {
+            throw std::runtime_error("Can't write checkpoint " + temporary);
+        }
+    }
+
+    // Readers see either the previous checkpoint or the complete new one
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Can't write checkpoint " + path);
+    }
+}
+
+void Checkpoint::save(const Population &population, const std::string &path) {
+    write_file(path, encode(population));
+}
+
+std::unique_ptr<Population> Checkpoint::load(const std::string &path,
+                                             std::function<void(std::vector<NetworkGenome> &)> evaluation) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Can't open checkpoint " + path);
+    }
+
+    std::vector<std::uint8_t> data(file.tellg());
+    file.seekg(0);
+    if (!file.read((char *) data.data(), (std::streamsize) data.size())) {
+        throw std::runtime_error("Can't read checkpoint " + path);
+    }
+
+    return decode(data.data(), data.size(), std::move(evaluation));
+}
+
+Checkpoint::Writer::~Writer() {
+    if (pending.valid()) pending.wait();
+}
+
+void Checkpoint::Writer::save(const Population &population, const std::string &path) {
+    wait();
+
+    // Encoding is done right away, the population may change as soon as this returns
+    pending = std::async(std::launch::async, [data = encode(population), path] {
+        write_file(path, data);
+    });
+}
+
+void Checkpoint::Writer::wait() {
+    if (pending.valid()) pending.get();
+}
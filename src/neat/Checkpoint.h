@@ -0,0 +1,104 @@
+#ifndef NEAT_CHECKPOINT_H
+#define NEAT_CHECKPOINT_H
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Population.h"
+
+/**
+ * Versioned binary snapshot of a population.
+ *
+ * A checkpoint contains hyperparameters, statistics, innovation state, random generator state,
+ * all genomes (encoded by GenomeCodec) and species. Restoring a checkpoint and evolving it gives
+ * the same results as evolving the original population (with a deterministic evaluation).
+ *
+ * File layout: magic "NEATCKPT", format version, then the encoded snapshot.
+ */
+class Checkpoint {
+private:
+    /**
+     * Write bytes into a file atomically (through a temporary file and rename).
+     * @param path path to the file
+     * @param data bytes to write
+     */
+    static void write_file(const std::string &path, const std::vector<std::uint8_t> &data);
+
+public:
+    static constexpr std::uint32_t version = 5;
+
+    /**
+     * Encode the state of a population.
+     * @param population population to encode
+     * @return encoded checkpoint
+     */
+    static std::vector<std::uint8_t> encode(const Population &population);
+
+    /**
+     * Restore a population from an encoded checkpoint. Throws std::runtime_error if the data is malformed.
+     * @param data encoded checkpoint
+     * @param size size of the encoded checkpoint
+     * @param evaluation function evaluating all genomes of the restored population
+     * @return restored population
+     */
+    static std::unique_ptr<Population> decode(const std::uint8_t *data, std::size_t size,
+                                              std::function<void(std::vector<NetworkGenome> &)> evaluation);
+
+    /**
+     * Write a checkpoint of a population into a file.
+     * @param population population to save
+     * @param path path to the file
+     */
+    static void save(const Population &population, const std::string &path);
+
+    /**
+     * Restore a population from a checkpoint file. The whole file is read with a single read.
+     * Throws std::runtime_error if the file can't be read or is malformed.
+     * @param path path to the file
+     * @param evaluation function evaluating all genomes of the restored population
+     * @return restored population
+     */
+    static std::unique_ptr<Population> load(const std::string &path,
+                                            std::function<void(std::vector<NetworkGenome> &)> evaluation);
+
+    /**
+     * Writes checkpoints in the background, so evolution doesn't wait for the disk.
+     * The population is encoded in memory by the calling thread, only writing happens in the background.
+     * At most one write is in progress, the next save waits for the previous one.
+     */
+    class Writer {
+    private:
+        std::future<void> pending;
+
+    public:
+        Writer() = default;
+
+        Writer(const Writer &) = delete;
+
+        Writer &operator=(const Writer &) = delete;
+
+        /**
+         * Wait for the last write.
+         */
+        ~Writer();
+
+        /**
+         * Encode population and start writing it into a file.
+         * @param population population to save
+         * @param path path to the file
+         */
+        void save(const Population &population, const std::string &path);
+
+        /**
+         * Wait until the last checkpoint is written. Rethrows an exception thrown while writing.
+         */
+        void wait();
+    };
+};
+
+
+#endif //NEAT_CHECKPOINT_H
@@ -0,0 +1,79 @@
+#include <stdexcept>
+
+#include "GenomeCodec.h"
+
+void GenomeCodec::encode(const NetworkGenome &genome, ByteWriter &writer) {
+    writer.write_varint(genome.input_count);
+    writer.write_varint(genome.output_count);
+    writer.write_double(genome.fitness);
+    writer.write_double(genome.raw_fitness);
+    writer.write_varint(genome.objectives.size());
+    for (double objective: genome.objectives) {
+        writer.write_double(objective);
+    }
+    writer.write_signed(genome.id);
+    writer.write_signed(genome.parents[0]);
+    writer.write_signed(genome.parents[1]);
+    writer.write_varint(genome.genome.size());
+
+    int previous = 0;
+    for (const auto &[innovation, gene]: genome.genome) {
+        writer.write_varint(innovation - previous);
+        writer.write_varint(gene.in);
+        writer.write_varint(gene.out);
+        writer.write_byte(gene.enabled);
+        writer.write_double(gene.weight);
+        previous = innovation;
+    }
+}
+
+std::vector<std::uint8_t> GenomeCodec::encode(const NetworkGenome &genome) {
+    std::vector<std::uint8_t> buffer;
+    ByteWriter writer(buffer);
+    encode(genome, writer);
+    return buffer;
+}
+
+NetworkGenome GenomeCodec::decode(ByteReader &reader, Population &population, std::pmr::memory_resource *resource) {
+    int input_count = (int) reader.read_varint();
+    int output_count = (int) reader.read_varint();
+    double fitness = reader.read_double();
+    double raw_fitness = reader.read_double();
+    std::size_t objective_count = reader.read_varint();
+    if (objective_count > reader.remaining() / 8) {
+        throw std::runtime_error("Malformed genome");
+    }
+    std::vector<double> objectives(objective_count);
+    for (double &objective: objectives) {
+        objective = reader.read_double();
+    }
+    long id = reader.read_signed();
+    long parent1 = reader.read_signed();
+    long parent2 = reader.read_signed();
+    std::size_t gene_count = reader.read_varint();
+
+    // Every gene takes at least 12 bytes
+    if (gene_count > reader.remaining() / 12) {
+        throw std::runtime_error("Malformed genome");
+    }
+
+    GeneMap genes(resource);
+    int innovation = 0;
+    for (std::size_t i = 0; i < gene_count; i++) {
+        innovation += (int) reader.read_varint();
+        int in = (int) reader.read_varint();
+        int out = (int) reader.read_varint();
+        bool enabled = reader.read_byte() != 0;
+        double weight = reader.read_double();
+        genes.emplace_hint(genes.end(), innovation, Gene(in, out, innovation, enabled, weight));
+    }
+
+    NetworkGenome genome(input_count, output_count, population, std::move(genes));
+    genome.fitness = fitness;
+    genome.raw_fitness = raw_fitness;
+    genome.objectives = std::move(objectives);
+    genome.id = id;
+    genome.parents[0] = parent1;
+    genome.parents[1] = parent2;
+    return genome;
+}
@@ -0,0 +1,46 @@
+#ifndef NEAT_GENOMECODEC_H
+#define NEAT_GENOMECODEC_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "NetworkGenome.h"
+#include "../utils/Bytes.h"
+
+/**
+ * Compact binary encoding of genomes, used for passing genomes between processes and storing them in files.
+ *
+ * A genome is encoded as input count, output count, fitness, raw fitness, objectives, id, parent ids and gene count,
+ * followed by genes ordered by innovation number.
+ * Each gene stores the difference from the previous innovation number, in and out node as varints, enabled flag and weight.
+ */
+class GenomeCodec {
+public:
+    /**
+     * Append encoded genome.
+     * @param genome genome to encode
+     * @param writer writer to append to
+     */
+    static void encode(const NetworkGenome &genome, ByteWriter &writer);
+
+    /**
+     * Encode a genome into a new buffer.
+     * @param genome genome to encode
+     * @return encoded genome
+     */
+    static std::vector<std::uint8_t> encode(const NetworkGenome &genome);
+
+    /**
+     * Decode a genome. Throws std::runtime_error on malformed data.
+     * @param reader reader positioned at encoded genome
+     * @param population population the genome belongs to
+     * @param resource memory resource genes are allocated from
+     * @return decoded genome
+     */
+    static NetworkGenome decode(ByteReader &reader, Population &population,
+                                std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+};
+
+
+#endif //NEAT_GENOMECODEC_H
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <numeric>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "IslandModel.h"
+#include "GenomeCodec.h"
+
+IslandModel::IslandModel(int island_count,
+                         std::function<std::unique_ptr<Population>(int, unsigned int)> create_population,
+                         unsigned int seed) : island_count(island_count), seed(seed),
+                                              create_population(std::move(create_population)) {}
+
+bool IslandModel::connected(int from, int to) const {
+    if (from == to) return false;
+    switch (topology) {
+        case MigrationTopology::Ring:
+            return to == (from + 1) % island_count;
+        case MigrationTopology::FullyConnected:
+        case MigrationTopology::Random:
+            return true;
+    }
+    return false;
+}
+
+void IslandModel::create_rings() {
+    ring_index.assign(island_count * island_count, -1);
+    int ring_count = 0;
+    for (int from = 0; from < island_count; from++) {
+        for (int to = 0; to < island_count; to++) {
+            if (connected(from, to)) ring_index[from * island_count + to] = ring_count++;
+        }
+    }
+
+    // Result rings hold a single genome each, but its size isn't known up front. Pages that are never touched
+    // aren't backed by memory, so the unused capacity costs nothing.
+    const std::size_t ring_size = SharedRing::required_size(ring_capacity);
+    memory = std::make_unique<SharedMemory>((ring_count + island_count) * ring_size);
+
+    rings.clear();
+    for (int i = 0; i < ring_count + island_count; i++) {
+        rings.emplace_back(memory->data() + i * ring_size, ring_capacity, true);
+    }
+}
+
+void IslandModel::emigrate(int island, const Population &population, Random &engine) {
+    // A single island has no neighbours
+    if (island_count < 2) return;
+
+    // Best genomes first
+    std::vector<int> order(population.genomes.size());
+    std::iota(order.begin(), order.end(), 0);
+    int count = std::min(migrant_count, (int) order.size());
+    std::partial_sort(order.begin(), order.begin() + count, order.end(), [&population](int a, int b) {
+        return population.genomes[a].fitness > population.genomes[b].fitness;
+    });
+
+    std::vector<int> targets;
+    if (topology == MigrationTopology::Random) {
+        int target = engine.integer(island_count - 1);
+        targets.push_back(target >= island ? target + 1 : target);
+    } else {
+        for (int to = 0; to < island_count; to++) {
+            if (connected(island, to)) targets.push_back(to);
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        auto encoded = GenomeCodec::encode(population.genomes[order[i]]);
+        for (int to: targets) {
+            // Ring full, the receiver is behind
+            rings[ring_index[island * island_count + to]].push(encoded.data(), encoded.size());
+        }
+    }
+}
+
+void IslandModel::immigrate(int island, Population &population) {
+    std::vector<NetworkGenome> migrants;
+    std::vector<std::uint8_t> message;
+    for (int from = 0; from < island_count; from++) {
+        if (!connected(from, island)) continue;
+
+        SharedRing &ring = rings[ring_index[from * island_count + island]];
+        while (ring.pop(message)) {
+            ByteReader reader(message.data(), message.size());
+            NetworkGenome migrant = GenomeCodec::decode(reader, population);
+            if (migrant.input_count == population.genomes.front().input_count &&
+                migrant.output_count == population.genomes.front().output_count) {
+                migrants.push_back(std::move(migrant));
+            }
+        }
+    }
+    if (migrants.empty()) return;
+
+    // Worst genomes first, the best genome is never replaced
+    auto &genomes = population.genomes;
+    std::vector<int> order(genomes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::erase_if(order, [&population](int i) { return &population.genomes[i] == population.best; });
+    std::sort(order.begin(), order.end(), [&genomes](int a, int b) {
+        return genomes[a].fitness < genomes[b].fitness;
+    });
+
+    const int count = (int) std::min(migrants.size(), order.size());
+    order.resize(count);
+    migrants.erase(migrants.begin() + count, migrants.end());
+    for (auto &migrant: migrants) {
+        // Innovation numbers are local to an island, so they are assigned again from connections
+        GeneMap genes(std::move(migrant.genome));
+        migrant.genome.clear();
+        for (const auto &[innovation, gene]: genes) {
+            int local_innovation = population.get_innovation_number(gene.in, gene.out);
+            migrant.genome[local_innovation] = Gene(gene.in, gene.out, local_innovation, gene.enabled, gene.weight);
+        }
+
+        // Ids are local to an island too, migrants have no known parents here
+        migrant.set_lineage(-1);
+    }
+
+    // Fitness of the home island isn't comparable, migrants are evaluated and speciated here
+    population.replace_genomes(order, migrants);
+}
+
+void IslandModel::run_island(int island, int generations) {
+    auto population = create_population(island, seed + island);
+    Random engine(seed + island);
+
+    for (int generation = 1; generation <= generations; generation++) {
+        population->evolution_step();
+
+        if (generation % migration_interval == 0 && generation < generations) {
+            emigrate(island, *population, engine);
+            immigrate(island, *population);
+        }
+    }
+
+    auto encoded = GenomeCodec::encode(*population->best);
+    rings[rings.size() - island_count + island].push(encoded.data(), encoded.size());
+}
+
+std::vector<IslandModel::Result> IslandModel::run(int generations) {
+    create_rings();
+
+    std::vector<pid_t> processes;
+    for (int island = 0; island < island_count; island++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            // Island process, never returns to the caller
+            int status = 0;
+            try {
+                run_island(island, generations);
+            } catch (...) {
+                status = 1;
+            }
+            _exit(status);
+        }
+        processes.push_back(pid);
+    }
+
+    std::vector<Result> results;
+    std::vector<std::uint8_t> message;
+    for (int island = 0; island < island_count; island++) {
+        Result result{island, false, 0, {}};
+
+        int status = 0;
+        bool exited = processes[island] > 0 && waitpid(processes[island], &status, 0) == processes[island] &&
+                      WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+        if (exited && rings[rings.size() - island_count + island].pop(message)) {
+            // Raw fitness follows input count, output count and shared fitness
+            ByteReader reader(message.data(), message.size());
+            reader.read_varint();
+            reader.read_varint();
+            reader.read_double();
+            result.best_fitness = reader.read_double();
+            result.best_genome = message;
+            result.completed = true;
+        }
+
+        results.push_back(std::move(result));
+    }
+
+    return results;
+}
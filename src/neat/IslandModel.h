@@ -0,0 +1,116 @@
+#ifndef NEAT_ISLANDMODEL_H
+#define NEAT_ISLANDMODEL_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Population.h"
+#include "../utils/SharedMemory.h"
+
+/**
+ * Which islands send migrants to which.
+ */
+enum class MigrationTopology {
+    Ring,           /// island i sends to island i + 1
+    FullyConnected, /// every island sends to every other island
+    Random          /// every migration goes to one randomly chosen island
+};
+
+/**
+ * Island model evolution, running several populations in separate processes.
+ *
+ * Each island is a forked process evolving its own population. Every migration_interval generations an island
+ * sends copies of its best genomes to its neighbours and replaces its worst genomes with migrants that arrived.
+ * Migrants travel through lock-free rings in memory shared by all islands (one ring per connected pair), so islands
+ * never wait for each other. Migrants keep the fitness they had on their home island until they are evaluated again.
+ */
+class IslandModel {
+private:
+    std::unique_ptr<SharedMemory> memory;
+
+    /**
+     * Index of the ring for every (from, to) pair of islands, -1 if islands aren't connected.
+     */
+    std::vector<int> ring_index;
+
+    /**
+     * Migration rings, followed by one result ring per island.
+     */
+    std::vector<SharedRing> rings;
+
+    /**
+     * Check whether migrants can go directly from one island to another.
+     */
+    [[nodiscard]] bool connected(int from, int to) const;
+
+    /**
+     * Create rings in new shared memory.
+     */
+    void create_rings();
+
+    /**
+     * Send best genomes of a population to neighbouring islands.
+     */
+    void emigrate(int island, const Population &population, Random &engine);
+
+    /**
+     * Replace worst genomes of a population with migrants waiting for the island.
+     */
+    void immigrate(int island, Population &population);
+
+    /**
+     * Evolve a single island. Runs in the island process.
+     */
+    void run_island(int island, int generations);
+
+public:
+    /**
+     * Outcome of a single island.
+     */
+    struct Result {
+        int island;
+        bool completed = false;   /// false if the island process failed
+        double best_fitness = 0;
+        std::vector<std::uint8_t> best_genome; /// best genome encoded by GenomeCodec
+    };
+
+    int island_count;
+    MigrationTopology topology = MigrationTopology::Ring;
+    int migration_interval = 10;
+    int migrant_count = 3;
+
+    /**
+     * Capacity of each migration ring in bytes. Migrants that don't fit are dropped.
+     */
+    std::size_t ring_capacity = 1 << 20;
+
+    /**
+     * Base seed, island i uses seed + i.
+     */
+    unsigned int seed;
+
+    /**
+     * Function creating the population of an island with a given seed. Called in the island process.
+     */
+    std::function<std::unique_ptr<Population>(int island, unsigned int seed)> create_population;
+
+    /**
+     * @param island_count number of islands (processes)
+     * @param create_population function creating the population of an island
+     * @param seed base seed of island populations
+     */
+    IslandModel(int island_count, std::function<std::unique_ptr<Population>(int, unsigned int)> create_population,
+                unsigned int seed = (unsigned int) time(nullptr));
+
+    /**
+     * Fork island processes, evolve each for a number of generations and wait for all of them.
+     * @param generations number of generations every island is evolved for
+     * @return results ordered by island
+     */
+    std::vector<Result> run(int generations);
+};
+
+
+#endif //NEAT_ISLANDMODEL_H
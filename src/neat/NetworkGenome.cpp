@@ -6,13 +6,16 @@
 #include "NetworkGenome.h"
 #include "../utils/GraphNetwork.h"
 
-NetworkGenome::NetworkGenome(int input_count, int output_count, Population &population, std::map<int, Gene> map)
+NetworkGenome::NetworkGenome(int input_count, int output_count, Population &population, GeneMap map)
         : input_count(input_count),
           output_count(output_count), population(population), genome(std::move(map)) {}
 
-NetworkGenome::NetworkGenome(int input_count, int output_count, Population &population) : input_count(input_count),
-                                                                                          output_count(output_count),
-                                                                                          population(population) {
+NetworkGenome::NetworkGenome(int input_count, int output_count, Population &population,
+                             std::pmr::memory_resource *resource) : input_count(input_count),
+                                                                    output_count(output_count),
+                                                                    population(population),
+                                                                    id(population.new_genome_id()),
+                                                                    genome(resource) {
     for (int i = 0; i < input_count; i++) {
         for (int j = 0; j < output_count; j++) {
             add_gene(i, input_count + j, population.random_weight());
@@ -33,8 +36,7 @@ void NetworkGenome::mutate_set_connection_weight(Gene &gene) {
 }
 
 void NetworkGenome::mutate_connection_weight() {
-    std::uniform_real_distribution<double> distribution(0, 1);
-    if (distribution(population.random_generator) < population.set_weight_chance) {
+    if (population.random_generator.bernoulli(population.set_weight_chance)) {
         mutate_perturb_connection_weight(random_gene());
     } else {
         mutate_set_connection_weight(random_gene());
@@ -54,6 +56,18 @@ void NetworkGenome::mutate_add_node() {
     g.enabled = false;
 }
 
+NetworkGenome::NetworkGenome(const NetworkGenome &genome, std::pmr::memory_resource *resource)
+        : input_count(genome.input_count),
+          output_count(genome.output_count), population(genome.population), fitness(genome.fitness),
+          raw_fitness(genome.raw_fitness), objectives(genome.objectives), fidelity(genome.fidelity), id(genome.id), parents{genome.parents[0], genome.parents[1]},
+          genome(genome.genome, resource) {}
+
+void NetworkGenome::set_lineage(long parent1, long parent2) {
+    id = population.new_genome_id();
+    parents[0] = parent1;
+    parents[1] = parent2;
+}
+
 int NetworkGenome::first_available_node_id() const {
     const int max_id = max_node_id();
 
@@ -120,42 +134,41 @@ void NetworkGenome::mutate_enable_connection() {
     random_gene().enabled = true;
 }
 
-NetworkGenome NetworkGenome::crossover(const NetworkGenome &parent1, const NetworkGenome &parent2) {
+NetworkGenome NetworkGenome::crossover(const NetworkGenome &parent1, const NetworkGenome &parent2,
+                                       std::pmr::memory_resource *resource) {
     int range = parent1.max_innovation_number();
 
     // Child's genome
-    std::map<int, Gene> genome;
-
-    std::uniform_real_distribution<double> distribution(0, 1);
+    GeneMap genome(resource);
 
     // Go through every possible innovation number of fitter parent
     for (int i = 0; i <= range; i++) {
         if (parent1.genome.contains(i)) {
             if (parent2.genome.contains(i)) {
                 // Matching genes
-                genome[i] =
-                        distribution(parent1.population.random_generator) < 0.5 ? parent1.genome.at(i)
-                                                                                : parent2.genome.at(i);
+                genome[i] = parent1.population.random_generator.bernoulli(0.5) ? parent1.genome.at(i)
+                                                                               : parent2.genome.at(i);
             } else {
                 // Excess/disjoint genes
                 genome[i] = parent1.genome.at(i);
             }
 
             // Chance to enable gene
-            if (distribution(parent1.population.random_generator) < parent1.population.enable_gene_chance) {
+            if (parent1.population.random_generator.bernoulli(parent1.population.enable_gene_chance)) {
                 genome[i].enabled = true;
             }
         }
     }
 
     // Create child
-    return {parent1.input_count, parent1.output_count, parent1.population, genome};
+    NetworkGenome child(parent1.input_count, parent1.output_count, parent1.population, std::move(genome));
+    child.set_lineage(parent1.id, parent2.id);
+    return child;
 }
 
 Gene &NetworkGenome::random_gene() {
     // Get random position of a gene
-    std::uniform_int_distribution<int> distribution(0, (int) genome.size() - 1);
-    int index = distribution(population.random_generator);
+    int index = population.random_generator.integer((int) genome.size());
 
     // Return gene in said position in sequence
     for (auto &p: genome) {
@@ -222,6 +235,14 @@ double NetworkGenome::get_compatibility_distance(const NetworkGenome &genome1, c
 }
 
 NetworkGenome &NetworkGenome::operator=(const NetworkGenome &g) {
+    if (this == &g) return *this;
+    fitness = g.fitness;
+    raw_fitness = g.raw_fitness;
+    objectives = g.objectives;
+    fidelity = g.fidelity;
+    id = g.id;
+    parents[0] = g.parents[0];
+    parents[1] = g.parents[1];
     genome = g.genome;
     return *this;
 }
\ No newline at end of file
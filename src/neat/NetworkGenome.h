@@ -2,6 +2,7 @@
 #define NEAT_NETWORKGENOME_H
 
 #include <map>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -10,16 +11,23 @@
 
 class Population;
 
+/**
+ * Map from innovation number to a gene. Genes are allocated from the memory resource of the generation.
+ */
+using GeneMap = std::pmr::map<int, Gene>;
+
 class NetworkGenome {
 private:
+    friend class GenomeCodec;
+
     /**
      * Construct NetworkGenome with given genes.
      * @param input_count	number of inputs
      * @param output_count	number of outputs
      * @param population    population containing the genome
-     * @param map           genome
+     * @param map           genome (must be allocated from the resource the genome should live in)
      */
-    NetworkGenome(int input_count, int output_count, Population &population, std::map<int, Gene> map);
+    NetworkGenome(int input_count, int output_count, Population &population, GeneMap map);
 
     /**
      * Calculate the biggest node id in the genome.
@@ -57,13 +65,47 @@ public:
      */
     double fitness;
 
+    /**
+     * Fitness before fitness sharing. (set by Population::evaluate)
+     */
+    double raw_fitness = 0;
+
+    /**
+     * Objectives of a multi-objective evaluation, all maximised. If the evaluation sets them,
+     * Population::evaluate derives fitness from Pareto front and crowding distance. (see ParetoSort)
+     */
+    std::vector<double> objectives;
+
+    /**
+     * Index of the fidelity fitness was evaluated at, -1 if the evaluation has a single fidelity.
+     * (see SuccessiveHalving)
+     */
+    int fidelity = -1;
+
+    /**
+     * Identifier unique within the population. Copies kept unchanged between generations keep their id.
+     */
+    long id = -1;
+
+    /**
+     * Identifiers of parents, -1 if there was no such parent.
+     */
+    long parents[2] = {-1, -1};
+
     /**
      * A map containing genes, mapping innovation number to a gene.
      */
-    std::map<int, Gene> genome;
+    GeneMap genome;
     const int input_count;
     const int output_count;
 
+    /**
+     * Give the genome a new id and set its parents.
+     * @param parent1 id of the first parent
+     * @param parent2 id of the second parent (-1 if the genome is a mutated copy)
+     */
+    void set_lineage(long parent1, long parent2 = -1);
+
     /**
      * Calculate a number of nodes.
      * @return a number of nodes
@@ -81,8 +123,22 @@ public:
      * @param input_count   number of inputs
      * @param output_count  number of outputs
      * @param population    population containing the genome
+     * @param resource      memory resource genes are allocated from
+     */
+    NetworkGenome(int input_count, int output_count, Population &population,
+                  std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    /**
+     * Copy a genome, allocating genes from a given memory resource.
+     * @param genome    genome to copy
+     * @param resource  memory resource genes are allocated from
      */
-    NetworkGenome(int input_count, int output_count, Population &population);
+    NetworkGenome(const NetworkGenome &genome, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    /**
+     * Move a genome. Genes stay in the memory resource they were allocated from.
+     */
+    NetworkGenome(NetworkGenome &&genome) noexcept = default;
 
     /**
      * Add a gene with given input, output and weight, assigning it an innovation number.
@@ -129,9 +185,11 @@ public:
      * Both genomes must have the same number of inputs and outputs and the same population.
      * @param parent1 parent with more fitness
      * @param parent2 parent with less fitness
+     * @param resource memory resource genes of the child are allocated from
      * @return child genome
      */
-    static NetworkGenome crossover(const NetworkGenome &parent1, const NetworkGenome &parent2);
+    static NetworkGenome crossover(const NetworkGenome &parent1, const NetworkGenome &parent2,
+                                   std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     /**
      * Calculate compatibility distance of two genomes (see NEAT paper)
@@ -145,6 +203,10 @@ public:
     static double get_compatibility_distance(const NetworkGenome &genome1, const NetworkGenome &genome2,
                                              double c1 = 1.0, double c2 = 1.0, double c3 = 0.4);
 
+    /**
+     * Copy genes and metadata (fitness, objectives, fidelity, id and parents) of a genome with the same population,
+     * input and output count. Genes are allocated from the memory resource of this genome.
+     */
     NetworkGenome &operator=(const NetworkGenome &g);
 };
 
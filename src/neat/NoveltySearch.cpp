@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cmath>
+
+#include "NoveltySearch.h"
+
+NoveltySearch::NoveltySearch(int dimensions, std::function<double(const NetworkGenome &, double *)> describe,
+                             ThreadPool &pool) : pool(pool), archive_tree(dimensions), population_tree(dimensions),
+                                                 dimensions(dimensions), describe(std::move(describe)) {}
+
+void NoveltySearch::operator()(std::vector<NetworkGenome> &genomes) {
+    const int n = (int) genomes.size();
+    behaviours.resize((std::size_t) n * dimensions);
+    std::vector<double> objective(n);
+    pool.parallel_for(n, [this, &genomes, &objective](int i) {
+        objective[i] = describe(genomes[i], behaviours.data() + (long) i * dimensions);
+    });
+    population_tree.build(behaviours);
+
+    std::vector<double> scores(n);
+    pool.parallel_for(n, [this, &scores](int i) {
+        scores[i] = novelty(behaviours.data() + (long) i * dimensions, true);
+    });
+
+    int added = 0;
+    for (int i = 0; i < n; i++) {
+        genomes[i].fitness = scores[i] + objective_weight * objective[i];
+
+        if (scores[i] > archive_threshold) {
+            archive.insert(archive.end(), behaviours.begin() + (long) i * dimensions,
+                           behaviours.begin() + (long) (i + 1) * dimensions);
+            added++;
+        }
+    }
+
+    // Keep the archive growing at a steady pace
+    if (added > max_additions) {
+        archive_threshold *= 1.2;
+    }
+    generations_without_addition = added == 0 ? generations_without_addition + 1 : 0;
+    if (generations_without_addition >= 5) {
+        archive_threshold *= 0.95;
+    }
+
+    if (archive_size() - indexed > rebuild_interval) {
+        archive_tree.build(archive);
+        indexed = archive_size();
+    }
+}
+
+double NoveltySearch::novelty(const double *behaviour, bool in_population) const {
+    // One more neighbour to account for the behaviour itself
+    const int count = in_population ? k + 1 : k;
+
+    std::vector<double> nearest;
+    nearest.reserve(count);
+    population_tree.nearest(behaviour, count, nearest);
+    archive_tree.nearest(behaviour, count, nearest);
+    for (int i = indexed; i < archive_size(); i++) {
+        KDTree::offer(nearest, count, KDTree::squared_distance(behaviour, archive.data() + (long) i * dimensions,
+                                                               dimensions));
+    }
+
+    // Skip the smallest distance, which is the behaviour itself
+    std::sort(nearest.begin(), nearest.end());
+    double sum = 0;
+    int neighbours = 0;
+    for (int i = in_population ? 1 : 0; i < (int) nearest.size(); i++) {
+        sum += std::sqrt(nearest[i]);
+        neighbours++;
+    }
+    return neighbours > 0 ? sum / neighbours : 0;
+}
+
+int NoveltySearch::archive_size() const {
+    return (int) (archive.size() / dimensions);
+}
@@ -0,0 +1,106 @@
+#ifndef NEAT_NOVELTYSEARCH_H
+#define NEAT_NOVELTYSEARCH_H
+
+#include <functional>
+#include <vector>
+
+#include "NetworkGenome.h"
+#include "../utils/KDTree.h"
+#include "../utils/ThreadPool.h"
+
+/**
+ * Novelty search evaluation (see Lehman and Stanley, Abandoning Objectives).
+ *
+ * Each genome is described by a behaviour (a vector of fixed dimension) and its fitness is its novelty,
+ * the average distance to k nearest behaviours among the current population and the archive.
+ * Sufficiently novel behaviours are added to the archive, with the threshold adapting to keep additions steady.
+ *
+ * The archive is kept in a k-d tree, entries added since the last rebuild are scanned linearly until there are
+ * rebuild_interval of them. Novelty of all genomes is computed in parallel, so scoring stays sub-linear
+ * in archive size even for archives of hundreds of thousands of behaviours.
+ *
+ * Can be used as population evaluation: Population(..., std::ref(novelty_search)).
+ */
+class NoveltySearch {
+private:
+    ThreadPool &pool;
+
+    /**
+     * Behaviours of the archive, dimensions values per behaviour.
+     */
+    std::vector<double> archive;
+
+    /**
+     * Tree over the first indexed archive behaviours.
+     */
+    KDTree archive_tree;
+    int indexed = 0;
+
+    /**
+     * Behaviours of the last evaluated generation and a tree over them.
+     */
+    std::vector<double> behaviours;
+    KDTree population_tree;
+
+    int generations_without_addition = 0;
+
+public:
+    const int dimensions;
+
+    /**
+     * Number of nearest neighbours novelty is averaged over.
+     */
+    int k = 15;
+
+    /**
+     * Novelty needed for a behaviour to be archived. Adapted every generation.
+     */
+    double archive_threshold = 1.0;
+
+    /**
+     * If more behaviours are archived in a generation, the threshold is raised.
+     */
+    int max_additions = 4;
+
+    /**
+     * Number of archived behaviours scanned linearly before the tree is rebuilt.
+     */
+    int rebuild_interval = 1024;
+
+    /**
+     * Weight of the objective returned by describe in fitness (0 for pure novelty search).
+     */
+    double objective_weight = 0;
+
+    /**
+     * Function describing a genome. Writes its behaviour (dimensions values) and returns its objective fitness.
+     * Called concurrently from pool threads.
+     */
+    std::function<double(const NetworkGenome &, double *)> describe;
+
+    /**
+     * @param dimensions dimension of behaviours
+     * @param describe function describing a genome (see describe)
+     * @param pool thread pool used for describing genomes and scoring novelty
+     */
+    NoveltySearch(int dimensions, std::function<double(const NetworkGenome &, double *)> describe, ThreadPool &pool);
+
+    /**
+     * Describe genomes, set their fitness to novelty and update the archive.
+     * @param genomes genomes to evaluate
+     */
+    void operator()(std::vector<NetworkGenome> &genomes);
+
+    /**
+     * Calculate novelty of a behaviour against the last generation and the archive.
+     * @param behaviour behaviour to score
+     * @param in_population true if the behaviour belongs to the last generation (its own distance is skipped)
+     * @return average distance to k nearest behaviours
+     */
+    [[nodiscard]] double novelty(const double *behaviour, bool in_population) const;
+
+    [[nodiscard]] int archive_size() const;
+};
+
+
+#endif //NEAT_NOVELTYSEARCH_H
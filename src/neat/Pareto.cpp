@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "Pareto.h"
+
+bool ParetoSort::dominates(const double *a, const double *b, int dimensions) {
+    bool better = false;
+    for (int i = 0; i < dimensions; i++) {
+        if (a[i] < b[i]) return false;
+        if (a[i] > b[i]) better = true;
+    }
+    return better;
+}
+
+bool ParetoSort::front_dominates(int front, int point) const {
+    const double *p = points + (std::size_t) point * dimensions;
+    const auto &members = fronts[front];
+
+    // Points of a front are sorted by the first objective and don't dominate each other, so with two
+    // objectives the last one added has the highest second objective and is the only one that can dominate
+    if (dimensions == 2) {
+        return dominates(points + (std::size_t) members.back() * dimensions, p, dimensions);
+    }
+
+    // Points added last are the most similar, so they are the most likely to dominate
+    for (auto it = members.rbegin(); it != members.rend(); it++) {
+        if (dominates(points + (std::size_t) *it * dimensions, p, dimensions)) return true;
+    }
+    return false;
+}
+
+void ParetoSort::sort(const double *point_data, int count, int dimension_count) {
+    points = point_data;
+    dimensions = dimension_count;
+
+    for (int i = 0; i < front_count; i++) {
+        fronts[i].clear();
+    }
+    front_count = 0;
+    ranks.assign(count, 0);
+    crowding.assign(count, 0);
+
+    // Sort lexicographically, so every point comes after all points dominating it
+    order.resize(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        const double *pa = points + (std::size_t) a * dimensions;
+        const double *pb = points + (std::size_t) b * dimensions;
+        for (int i = 0; i < dimensions; i++) {
+            if (pa[i] != pb[i]) return pa[i] > pb[i];
+        }
+        return false;
+    });
+
+    for (int point: order) {
+        // If a front dominates the point, so do all fronts before it
+        int low = 0;
+        int high = front_count;
+        while (low < high) {
+            int middle = (low + high) / 2;
+            if (front_dominates(middle, point)) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        if (low == front_count) {
+            if ((int) fronts.size() == front_count) fronts.emplace_back();
+            front_count++;
+        }
+        fronts[low].push_back(point);
+        ranks[point] = low;
+    }
+
+    for (int i = 0; i < front_count; i++) {
+        calculate_crowding(i);
+    }
+}
+
+void ParetoSort::calculate_crowding(int front) {
+    const auto &members = fronts[front];
+    if (members.size() <= 2) {
+        for (int point: members) {
+            crowding[point] = std::numeric_limits<double>::infinity();
+        }
+        return;
+    }
+
+    by_objective.assign(members.begin(), members.end());
+    for (int d = 0; d < dimensions; d++) {
+        auto value = [this, d](int point) {
+            return points[(std::size_t) point * dimensions + d];
+        };
+        std::sort(by_objective.begin(), by_objective.end(), [&value](int a, int b) {
+            return value(a) < value(b);
+        });
+
+        crowding[by_objective.front()] = std::numeric_limits<double>::infinity();
+        crowding[by_objective.back()] = std::numeric_limits<double>::infinity();
+
+        double range = value(by_objective.back()) - value(by_objective.front());
+        // Infinite objectives (failed evaluations) give no information about spacing
+        if (!(range > 0) || std::isinf(range)) continue;
+
+        for (std::size_t i = 1; i + 1 < by_objective.size(); i++) {
+            crowding[by_objective[i]] += (value(by_objective[i + 1]) - value(by_objective[i - 1])) / range;
+        }
+    }
+}
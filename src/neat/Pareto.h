@@ -0,0 +1,86 @@
+#ifndef NEAT_PARETO_H
+#define NEAT_PARETO_H
+
+#include <vector>
+
+/**
+ * Non-dominated sorting and crowding distance of points in objective space. (see NSGA-II paper)
+ * All objectives are maximised.
+ *
+ * Fronts are found with efficient non-dominated sort using binary search (ENS-BS), which sorts points
+ * lexicographically, so that a point can only be dominated by points before it, then finds the front of
+ * each point with a binary search over the fronts found so far. For two objectives only the last point of
+ * a front has to be compared, giving O(N log N) in total.
+ *
+ * Buffers are kept between sorts, so sorting a population of the same size doesn't allocate.
+ */
+class ParetoSort {
+private:
+    /**
+     * Indices of points, sorted lexicographically in descending order.
+     */
+    std::vector<int> order;
+
+    /**
+     * Indices of points in each front, in the order they were added. Only the first front_count are used.
+     */
+    std::vector<std::vector<int>> fronts;
+
+    /**
+     * Points of a front sorted by a single objective. (used when calculating crowding distance)
+     */
+    std::vector<int> by_objective;
+
+    /**
+     * Check whether any point of a front dominates a given point.
+     * @param front index of the front
+     * @param point index of the point
+     * @return true if point is dominated by the front
+     */
+    [[nodiscard]] bool front_dominates(int front, int point) const;
+
+    /**
+     * Calculate crowding distance of points in a front.
+     * @param front index of the front
+     */
+    void calculate_crowding(int front);
+
+    const double *points = nullptr;
+    int dimensions = 0;
+
+public:
+    /**
+     * Front of each point, 0 being the non-dominated front.
+     */
+    std::vector<int> ranks;
+
+    /**
+     * Crowding distance of each point within its front. Boundary points of a front have infinite distance.
+     */
+    std::vector<double> crowding;
+
+    /**
+     * Number of fronts found by the last sort.
+     */
+    int front_count = 0;
+
+    /**
+     * Sort points into fronts and calculate their crowding distances.
+     * Objectives must not be NaN.
+     * @param point_data objectives of consecutive points, dimensions values per point
+     * @param count number of points
+     * @param dimension_count number of objectives
+     */
+    void sort(const double *point_data, int count, int dimension_count);
+
+    /**
+     * Check whether a point dominates another one (is not worse in any objective and better in at least one).
+     * @param a objectives of the first point
+     * @param b objectives of the second point
+     * @param dimensions number of objectives
+     * @return true if a dominates b
+     */
+    static bool dominates(const double *a, const double *b, int dimensions);
+};
+
+#endif
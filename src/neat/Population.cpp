@@ -1,12 +1,21 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
 #include <utility>
 #include "Population.h"
 
-Population::Population(int size, int inputs, int outputs, std::function<void(std::vector<NetworkGenome>&)> evaluation) :
+Population::Population(int size, int inputs, int outputs, std::function<void(std::vector<NetworkGenome>&)> evaluation,
+                       unsigned int seed, const std::function<void(Population &)> &configure) :
         size(size), evaluation(std::move(evaluation)) {
-    random_generator = std::default_random_engine(time(NULL));
+    random_generator = Random(seed);
+    if (configure) configure(*this);
+    genomes.reserve(size);
+    next_genomes.reserve(size);
     for (int i = 0; i < size; i++) {
-        genomes.emplace_back(inputs, outputs, *this);
+        genomes.emplace_back(inputs, outputs, *this, arena);
     }
 
     mutate();
@@ -14,6 +23,12 @@ Population::Population(int size, int inputs, int outputs, std::function<void(std
     evaluate();
 }
 
+Population::Population(int size, std::function<void(std::vector<NetworkGenome> &)> evaluation) :
+        size(size), evaluation(std::move(evaluation)) {
+    genomes.reserve(size);
+    next_genomes.reserve(size);
+}
+
 int Population::get_innovation_number(int in, int out) {
     // Search for equal connection
     for (const auto &innovation: innovations) {
@@ -30,52 +45,63 @@ int Population::get_innovation_number(int in, int out) {
     return innovation_number++;
 }
 
+long Population::new_genome_id() {
+    return next_genome_id++;
+}
+
 double Population::random_weight() {
-    std::uniform_real_distribution<double> distribution(-1, 1);
-    return distribution(random_generator);
+    return random_generator.uniform(-1, 1);
 }
 
 double Population::random_perturbation() {
-    std::uniform_real_distribution distribution(-0.1, 0.1);
-    return distribution(random_generator);
+    return random_generator.uniform(-0.1, 0.1);
 }
 
-void Population::mutate() {
-    std::uniform_real_distribution<double> distribution(0, 1);
-    for (auto &genome: genomes) {
-        if (distribution(random_generator) < weight_mutation_chance) genome.mutate_connection_weight();
-        if (distribution(random_generator) < add_connection_mutation_chance) genome.mutate_add_connection();
-        if (distribution(random_generator) < add_node_mutation_chance) genome.mutate_add_node();
+void Population::mutate(int first) {
+    for (auto it = genomes.begin() + first; it != genomes.end(); it++) {
+        mutate_genome(*it);
     }
 }
 
+void Population::mutate_genome(NetworkGenome &genome) {
+    if (random_generator.bernoulli(weight_mutation_chance)) genome.mutate_connection_weight();
+    if (random_generator.bernoulli(add_connection_mutation_chance)) genome.mutate_add_connection();
+    if (random_generator.bernoulli(add_node_mutation_chance)) genome.mutate_add_node();
+}
+
 void Population::speciate() {
     for (auto &s: species) {
         s.genomes.clear();
     }
 
-    for (auto &genome: genomes) {
-        insert_into_species(genome);
+    for (int i = 0; i < (int) genomes.size(); i++) {
+        insert_into_species(i);
     }
 
     auto r = std::remove_if(species.begin(), species.end(), [](const Species &s) {
         return s.genomes.empty();
     });
     species.erase(r, species.end());
+
+    index_species();
 }
 
-void Population::insert_into_species(NetworkGenome &genome) {
-    bool inserted = false;
-    for (auto &s: species) {
-        if (s.insert_genome(genome)) {
-            inserted = true;
-            break;
+void Population::index_species() {
+    genome_species.assign(genomes.size(), -1);
+    for (int i = 0; i < (int) species.size(); i++) {
+        for (int index: species[i].genomes) {
+            genome_species[index] = i;
         }
     }
+}
 
-    if (!inserted) {
-        species.emplace_back(genome);
+int Population::insert_into_species(int index) {
+    for (int i = 0; i < (int) species.size(); i++) {
+        if (species[i].insert_genome(index)) return i;
     }
+
+    species.emplace_back(*this, index);
+    return (int) species.size() - 1;
 }
 
 void Population::normalise_fitness() {
@@ -84,12 +110,66 @@ void Population::normalise_fitness() {
     }
 }
 
+double Population::survival_cutoff(const NetworkGenome &genome) const {
+    auto index = &genome - genomes.data();
+    if (index < 0 || index >= (long) genomes.size()) {
+        auto it = std::find_if(genomes.begin(), genomes.end(), [&genome](const NetworkGenome &g) {
+            return g.id == genome.id;
+        });
+        index = it - genomes.begin();
+    }
+    if (index >= (long) genome_species.size()) return 0;
+    int s = genome_species[index];
+    if (s < 0 || s >= (int) species.size()) return 0;
+    return species[s].survival_cutoff;
+}
+
+void Population::pareto_fitness() {
+    const int dimensions = (int) genomes.front().objectives.size();
+    objective_buffer.clear();
+    for (const auto &genome: genomes) {
+        if ((int) genome.objectives.size() != dimensions) {
+            throw std::invalid_argument("Genomes have different numbers of objectives");
+        }
+        for (double objective: genome.objectives) {
+            // A failed evaluation is worse than any other
+            objective_buffer.push_back(std::isnan(objective) ? -std::numeric_limits<double>::infinity() : objective);
+        }
+    }
+
+    pareto.sort(objective_buffer.data(), (int) genomes.size(), dimensions);
+
+    for (int i = 0; i < (int) genomes.size(); i++) {
+        // Crowding term stays within [0, 0.5], so it never lifts a genome above a better front
+        double crowding = pareto.crowding[i];
+        double spread = std::isinf(crowding) ? 0.5 : 0.5 * crowding / (1 + crowding);
+        genomes[i].fitness = (double) (pareto.front_count - pareto.ranks[i]) + spread;
+    }
+}
+
 void Population::evaluate() {
-    evaluation(genomes);
+    if (surrogate.enabled) {
+        surrogate.evaluate(*this);
+    } else {
+        evaluation(genomes);
+    }
+    update_fitness();
+}
+
+void Population::update_fitness() {
+    if (!genomes.empty() && !genomes.front().objectives.empty()) {
+        pareto_fitness();
+    }
+
+    best = nullptr;
     best_fitness = -1;
     average_fitness = 0;
-    for (const auto &genome: genomes) {
-        if (genome.fitness > best_fitness) {
+    for (int i = 0; i < (int) genomes.size(); i++) {
+        NetworkGenome &genome = genomes[i];
+        genome.raw_fitness = genome.fitness;
+
+        // Predicted fitness isn't verified, so only evaluated genomes can be the best
+        if (genome.fitness > best_fitness && !surrogate.predicted(i)) {
             best = &genome;
             best_fitness = best->fitness;
         }
@@ -97,46 +177,106 @@ void Population::evaluate() {
         average_fitness += genome.fitness;
     }
     average_fitness /= (double) genomes.size();
+    if (best == nullptr && !genomes.empty()) {
+        best = &*std::max_element(genomes.begin(), genomes.end(), [](const NetworkGenome &a, const NetworkGenome &b) {
+            return a.fitness < b.fitness;
+        });
+        best_fitness = best->fitness;
+    }
     normalise_fitness();
 }
 
+void Population::replace_genomes(const std::vector<int> &indices, std::vector<NetworkGenome> &replacements) {
+    for (auto &genome: replacements) {
+        genome.fitness = 0;
+        genome.objectives.clear();
+    }
+    evaluation(replacements);
+    for (auto &genome: replacements) {
+        genome.raw_fitness = genome.fitness;
+    }
+
+    for (int index: indices) {
+        std::erase(species.at(genome_species.at(index)).genomes, index);
+    }
+    for (int i = 0; i < (int) indices.size(); i++) {
+        genomes[indices[i]] = replacements[i];
+        surrogate.mark_evaluated(indices[i]);
+        insert_into_species(indices[i]);
+    }
+    std::erase_if(species, [](const Species &s) {
+        return s.genomes.empty();
+    });
+    index_species();
+
+    // Local fitness was normalised by the old species sizes
+    for (auto &genome: genomes) {
+        genome.fitness = genome.raw_fitness;
+    }
+    update_fitness();
+}
+
 void Population::next_generation() {
-    std::vector<NetworkGenome> champions;
-    champions.push_back(*best);
+    // Release the previous generation
+    next_genomes.clear();
+    next_arena->reset();
+
+    build_selectors();
+
+    next_genomes.emplace_back(*best, next_arena);
     for (const auto &s: species) {
         if (s.genomes.size() >= 5) {
-            champions.push_back(*s.genomes.front());
+            auto champion = std::find_if(s.genomes.begin(), s.genomes.end(), [this](int index) {
+                return !surrogate.predicted(index);
+            });
+            if (champion != s.genomes.end()) next_genomes.emplace_back(genomes[*champion], next_arena);
         }
     }
+    int champion_count = (int) next_genomes.size();
     double total_fitness = std::accumulate(species.begin(), species.end(), 0.0, [](double init, const Species &s) {
         return init + s.fitness;
     });
-    int remaining = size - (int) champions.size();
-    std::vector<NetworkGenome> new_population;
+    int remaining = size - champion_count;
     for (auto &s: species) {
 
         s.reduce_population();
-        int to_add = (int) ((double) (size - champions.size()) * s.fitness / total_fitness);
-        s.get_offspring(to_add, new_population);
+        int to_add = (int) ((double) (size - champion_count) * s.fitness / total_fitness);
+        s.get_offspring(to_add, next_genomes, next_arena);
         remaining -= to_add;
     }
 
     for (int i = 0; i < remaining; i++) {
-        new_population.push_back(NetworkGenome::crossover(random_genome(), random_genome()));
+        next_genomes.push_back(NetworkGenome::crossover(random_genome(), random_genome(), next_arena));
     }
 
-    genomes = new_population;
+    genomes.swap(next_genomes);
+    std::swap(arena, next_arena);
 
-    mutate();
+    mutate(champion_count);
+}
 
-    genomes.insert(genomes.begin(), champions.begin(), champions.end());
+void Population::compact() {
+    next_genomes.clear();
+    next_arena->reset();
+
+    for (const auto &genome: genomes) {
+        next_genomes.emplace_back(genome, next_arena);
+    }
+
+    // Keep best pointing at the same genome
+    if (best != nullptr && best >= genomes.data() && best < genomes.data() + genomes.size()) {
+        best = &next_genomes[best - genomes.data()];
+    }
+
+    genomes.swap(next_genomes);
+    std::swap(arena, next_arena);
 }
 
 void Population::evolution_step() {
     for(auto& s : species) {
-        for(const auto& genome : s.genomes) {
+        for(int index : s.genomes) {
             s.generations_left--;
-            if(genome->fitness > s.max_fitness) {
+            if(genomes[index].fitness > s.max_fitness) {
                 s.generations_left = 15;
             }
         }
@@ -151,9 +291,37 @@ void Population::evolution_step() {
     next_generation();
     speciate();
     evaluate();
+    generation++;
+}
+
+void Population::build_selectors() {
+    std::vector<double> fitness;
+    fitness.reserve(genomes.size());
+    for (const auto &genome: genomes) {
+        fitness.push_back(genome.fitness);
+    }
+    genome_selector.build(fitness, selection_method, tournament_size);
+
+    build_species_selector();
+}
+
+void Population::build_species_selector() {
+    std::vector<double> fitness;
+    fitness.reserve(species.size());
+    for (const auto &s: species) {
+        fitness.push_back(s.fitness);
+    }
+    species_selector.build(fitness, selection_method, tournament_size);
 }
 
 const NetworkGenome &Population::random_genome() {
-    std::uniform_int_distribution<int> distribution(0, size - 1);
-    return genomes.at(distribution(random_generator));
+    return random_genome(random_generator);
+}
+
+const NetworkGenome &Population::random_genome(Random &engine) const {
+    return genomes.at(genome_selector.select(engine));
+}
+
+Species &Population::random_species() {
+    return species.at(species_selector.select(random_generator));
 }
\ No newline at end of file
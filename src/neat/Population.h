@@ -3,18 +3,68 @@
 
 #include <tuple>
 #include <vector>
-#include <random>
+#include <ctime>
 #include <functional>
 
 #include "NetworkGenome.h"
 #include "Gene.h"
 #include "Species.h"
+#include "Selection.h"
+#include "Pareto.h"
+#include "Surrogate.h"
+#include "../utils/Arena.h"
+#include "../utils/Random.h"
 
 class Species;
 
 class Population {
 private:
+    friend class Checkpoint;
+    friend class Surrogate;
+
     const int size; /// Population size
+
+    /**
+     * Arenas holding genes of the current and the next generation. (see arena and next_arena)
+     */
+    Arena arenas[2];
+
+    /**
+     * Storage for the next generation. Holds the previous generation until it is rebuilt.
+     */
+    std::vector<NetworkGenome> next_genomes;
+
+    /**
+     * Selector over all genomes. (see random_genome)
+     */
+    Selector genome_selector;
+
+    /**
+     * Selector over species. (see random_species)
+     */
+    Selector species_selector;
+
+    /**
+     * Sorts genomes into Pareto fronts when the evaluation sets objectives. (see pareto_fitness)
+     */
+    ParetoSort pareto;
+
+    /**
+     * Objectives of all genomes, passed to pareto.
+     */
+    std::vector<double> objective_buffer;
+
+    /**
+     * Create an empty population with no genomes. (used when restoring a checkpoint)
+     * @param size size of the population
+     * @param evaluation function evaluating all genomes
+     */
+    Population(int size, std::function<void(std::vector<NetworkGenome> &)> evaluation);
+
+    /**
+     * Set genome_species from species.
+     */
+    void index_species();
 public:
     double enable_gene_chance = 0.25;
     double weight_mutation_chance = 0.8;
@@ -25,6 +75,12 @@ public:
     double non_crossover_breeding_rate = 0.25;
     double selection_rate = 0.25;
 
+    /**
+     * Method used for choosing parents, both in the whole population and in species.
+     */
+    SelectionMethod selection_method = SelectionMethod::FitnessProportional;
+    int tournament_size = 3;
+
     double compatibility_threshold = 3.0;
     double c1 = 1.0;
     double c2 = 1.0;
@@ -32,6 +88,7 @@ public:
 
     const NetworkGenome *best = nullptr;
     double best_fitness = 0;
+    int generation = 0;
     double average_fitness = 0;
 
     /**
@@ -39,10 +96,33 @@ public:
      */
     std::function<void(std::vector<NetworkGenome> &)> evaluation;
 
+    /**
+     * Model predicting fitness, used to evaluate only promising genomes when enabled.
+     */
+    Surrogate surrogate;
+
+    /**
+     * Genomes of the current generation. Genes are allocated from arena.
+     */
     std::vector<NetworkGenome> genomes;
 
+    /**
+     * Arena containing genes of the current generation.
+     */
+    Arena *arena = &arenas[0];
+
+    /**
+     * Arena the next generation is built in. Swapped with arena after reproduction.
+     */
+    Arena *next_arena = &arenas[1];
+
     std::vector<Species> species;
 
+    /**
+     * Index of the species of each genome, set by speciate.
+     */
+    std::vector<int> genome_species;
+
     /**
      * Vector of unique mutations this generation. Only in, out and innovation number matter.
      */
@@ -50,15 +130,26 @@ public:
 
     int innovation_number = 0;
 
-    std::default_random_engine random_generator;
+    /**
+     * Id given to the next new genome.
+     */
+    long next_genome_id = 0;
+
+    Random random_generator;
 
     /**
      * Create a random population of size genomes. Genomes have default topologies.
      * @param size size of the population
      * @param inputs input count of genomes
      * @param outputs output count of genomes
+     * @param evaluation function evaluating all genomes
+     * @param seed seed of the random generator
+     * @param configure function setting parameters (mutation chances, speciation...), called before the first
+     * generation is mutated, speciated and evaluated
      */
-    Population(int size, int inputs, int outputs, std::function<void(std::vector<NetworkGenome> &)> evaluation);
+    Population(int size, int inputs, int outputs, std::function<void(std::vector<NetworkGenome> &)> evaluation,
+               unsigned int seed = (unsigned int) time(nullptr),
+               const std::function<void(Population &)> &configure = nullptr);
 
     /**
      * Get innovation number for genome containing connection from in to out.
@@ -71,6 +162,12 @@ public:
      */
     int get_innovation_number(int in, int out);
 
+    /**
+     * Get an id for a new genome.
+     * @return unique id
+     */
+    long new_genome_id();
+
     /**
      * Calculate a random connection weight.
      * @return connection weight
@@ -84,9 +181,16 @@ public:
     double random_perturbation();
 
     /**
-     * Mutate all genomes in the population
+     * Mutate genomes in the population.
+     * @param first index of the first genome to mutate
+     */
+    void mutate(int first = 0);
+
+    /**
+     * Apply random mutations to a single genome.
+     * @param genome
      */
-    void mutate();
+    void mutate_genome(NetworkGenome &genome);
 
     /**
      * Clear species, assign each genome to a species, then manage species.
@@ -94,16 +198,50 @@ public:
     void speciate();
 
     /**
-     * Insert genome into species.
-     * @param genome
+     * Insert genome into the first compatible species, or a new one. Doesn't update genome_species.
+     * @param index index of the genome in genomes
+     * @return index of the species the genome was inserted into
+     */
+    int insert_into_species(int index);
+
+    /**
+     * Get the survival cutoff of the species of a genome. (see Species::survival_cutoff)
+     * Genome can be in genomes or a copy of one (found by id).
+     * @param genome genome of the current generation
+     * @return raw fitness needed to survive, 0 if unknown
      */
-    void insert_into_species(NetworkGenome &genome);
+    [[nodiscard]] double survival_cutoff(const NetworkGenome &genome) const;
 
     /**
-     * Evaluate genome fitness.
+     * Evaluate genome fitness (through the surrogate if it is enabled), then update fitness. (see update_fitness)
      */
     void evaluate();
 
+    /**
+     * Derive fitness from objectives if the evaluation sets them (see pareto_fitness), set raw fitness, find the
+     * best genome and the average fitness, then normalise fitness within species.
+     * Fitness must not be normalised yet.
+     */
+    void update_fitness();
+
+    /**
+     * Replace genomes with genomes of another population (for example migrants of an island model).
+     * Their fitness isn't comparable with local fitness, so they are evaluated here. Replaced genomes leave their
+     * species, new genomes join compatible species, and fitness of all genomes is normalised again.
+     * Genomes must be speciated and evaluated, the best genome must not be replaced.
+     * @param indices indices of replaced genomes
+     * @param replacements genomes with genes numbered by innovations of this population, one per index
+     */
+    void replace_genomes(const std::vector<int> &indices, std::vector<NetworkGenome> &replacements);
+
+    /**
+     * Set fitness of genomes from their objectives: genomes in better Pareto fronts get higher fitness,
+     * and within a front, genomes with higher crowding distance do. (see NSGA-II paper)
+     * Fitness is at least 1, and the ordering survives fitness sharing within species.
+     * Every genome must have the same number of objectives.
+     */
+    void pareto_fitness();
+
     /**
      * Reduce fitness based on number of genomes in a species. (see NEAT paper)
      */
@@ -111,23 +249,52 @@ public:
 
     /**
      * Replace current genome population with a new generation.
+     * The new generation is built in the next arena, then the arenas are swapped.
+     * The previous generation is released when the one after it is built.
      */
     void next_generation();
 
+    /**
+     * Build selectors over genomes and species using selection_method.
+     * Called once per generation, before reproduction.
+     */
+    void build_selectors();
+
+    /**
+     * Build only the selector over species. (used when species fitness changes without a new generation)
+     */
+    void build_species_selector();
+
     /**
      * Choose a random genome based on all genome fitnesses.
      * (more fit genomes are more likely to be chosen)
+     * Selectors must be built.
      * @return a random genome
      */
     const NetworkGenome &random_genome();
 
+    /**
+     * Choose a random genome using given random engine. Safe to call from multiple threads.
+     * Selectors must be built.
+     * @param engine random number engine used by the calling thread
+     * @return a random genome
+     */
+    [[nodiscard]] const NetworkGenome &random_genome(Random &engine) const;
+
     /**
      * Choose a random species based on all species fitnesses.
      * (species with higher average fitness is more likely to be chosen)
+     * Selectors must be built.
      * @return a random species
      */
     Species &random_species();
 
+    /**
+     * Copy current genomes into the next arena and swap arenas, releasing memory of replaced genes.
+     * Order of genomes is kept, so species stay valid.
+     */
+    void compact();
+
     /**
      * Evaluate and normalise genome fitnesses, then create new generation.
      */
@@ -0,0 +1,189 @@
+#include <cerrno>
+#include <csignal>
+#include <deque>
+#include <system_error>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ProcessEvaluator.h"
+#include "GenomeCodec.h"
+
+ProcessEvaluator::ProcessEvaluator(int worker_count, std::function<double(const NetworkGenome &)> evaluation)
+        : worker_count(worker_count), evaluation(std::move(evaluation)) {}
+
+ProcessEvaluator::~ProcessEvaluator() {
+    for (int i = 0; i < (int) workers.size(); i++) {
+        stop_worker(i);
+    }
+}
+
+void ProcessEvaluator::start() {
+    for (int i = 0; i < (int) workers.size(); i++) {
+        stop_worker(i);
+    }
+    workers.clear();
+
+    const std::size_t ring_size = SharedRing::required_size(ring_capacity);
+    memory = std::make_unique<SharedMemory>(2 * worker_count * ring_size);
+    for (int i = 0; i < worker_count; i++) {
+        std::uint8_t *rings = memory->data() + 2 * i * ring_size;
+        workers.push_back({-1, SharedRing(rings, ring_capacity, true),
+                           SharedRing(rings + ring_size, ring_capacity, true), {}});
+        start_worker(i);
+    }
+}
+
+void ProcessEvaluator::start_worker(int index) {
+    Worker &worker = workers[index];
+    worker.requests = SharedRing(memory->data() + 2 * index * SharedRing::required_size(ring_capacity),
+                                 ring_capacity, true);
+    worker.completions = SharedRing(memory->data() + (2 * index + 1) * SharedRing::required_size(ring_capacity),
+                                    ring_capacity, true);
+    worker.jobs.clear();
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Worker process, never returns to the caller. A failed evaluation exits and the worker is restarted.
+        try {
+            work(index);
+        } catch (...) {
+        }
+        _exit(1);
+    }
+    if (pid < 0) {
+        throw std::system_error(errno, std::generic_category(), "fork");
+    }
+    worker.pid = pid;
+}
+
+void ProcessEvaluator::stop_worker(int index) {
+    Worker &worker = workers[index];
+    if (worker.pid > 0) {
+        kill(worker.pid, SIGKILL);
+        waitpid(worker.pid, nullptr, 0);
+    }
+    worker.pid = -1;
+}
+
+void ProcessEvaluator::work(int index) {
+    Worker &worker = workers[index];
+    const pid_t parent = getppid();
+
+    std::vector<std::uint8_t> message;
+    std::vector<std::uint8_t> completion;
+    int idle = 0;
+    while (true) {
+        if (!worker.requests.pop(message)) {
+            // Spin for a while, then back off to avoid burning a core between generations
+            if (++idle < 1000) {
+                std::this_thread::yield();
+            } else {
+                if (getppid() != parent) _exit(0);
+                usleep(100);
+            }
+            continue;
+        }
+        idle = 0;
+
+        ByteReader reader(message.data(), message.size());
+        auto genome_index = reader.read_varint();
+        NetworkGenome genome = GenomeCodec::decode(reader, *population);
+        double fitness = evaluation(genome);
+
+        completion.clear();
+        ByteWriter writer(completion);
+        writer.write_varint(genome_index);
+        writer.write_double(fitness);
+        while (!worker.completions.push(completion.data(), completion.size())) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ProcessEvaluator::operator()(std::vector<NetworkGenome> &genomes) {
+    if (genomes.empty()) return;
+    if (population != &genomes.front().population) {
+        population = &genomes.front().population;
+        start();
+    }
+
+    // Encode every genome once, together with its index
+    std::vector<std::uint8_t> encoded;
+    std::vector<std::size_t> offsets;
+    ByteWriter writer(encoded);
+    for (int i = 0; i < (int) genomes.size(); i++) {
+        offsets.push_back(encoded.size());
+        writer.write_varint(i);
+        GenomeCodec::encode(genomes[i], writer);
+    }
+    offsets.push_back(encoded.size());
+
+    std::deque<int> pending;
+    for (int i = 0; i < (int) genomes.size(); i++) {
+        pending.push_back(i);
+    }
+    std::vector<int> attempts(genomes.size(), 0);
+    int remaining = (int) genomes.size();
+
+    std::vector<std::uint8_t> message;
+    while (remaining > 0) {
+        bool progress = false;
+        auto now = std::chrono::steady_clock::now();
+
+        for (int w = 0; w < (int) workers.size(); w++) {
+            Worker &worker = workers[w];
+
+            // Collect finished evaluations
+            bool completed = false;
+            while (worker.completions.pop(message)) {
+                ByteReader reader(message.data(), message.size());
+                int genome = (int) reader.read_varint();
+                genomes[genome].fitness = reader.read_double();
+
+                // Jobs are processed in order, the next one starts now
+                worker.jobs.erase(worker.jobs.begin());
+                if (!worker.jobs.empty()) worker.jobs.front().start = now;
+                remaining--;
+                completed = true;
+            }
+            progress |= completed;
+
+            // Restart crashed or stuck worker
+            bool stuck = timeout.count() > 0 && !worker.jobs.empty() && now - worker.jobs.front().start > timeout;
+            bool crashed = !completed && worker.pid > 0 && waitpid(worker.pid, nullptr, WNOHANG) == worker.pid;
+            if (crashed) worker.pid = -1;
+            if (stuck || crashed) {
+                stop_worker(w);
+
+                // First job was being evaluated, the rest is sent again as is
+                for (int j = (int) worker.jobs.size() - 1; j >= 0; j--) {
+                    int genome = worker.jobs[j].genome;
+                    if (j == 0 && ++attempts[genome] >= max_attempts) {
+                        genomes[genome].fitness = 0;
+                        remaining--;
+                    } else {
+                        pending.push_front(genome);
+                    }
+                }
+
+                start_worker(w);
+                restarts++;
+                progress = true;
+            }
+
+            // Keep the worker's queue full
+            while (!pending.empty() && (int) worker.jobs.size() < jobs_per_worker) {
+                int genome = pending.front();
+                if (!worker.requests.push(encoded.data() + offsets[genome], offsets[genome + 1] - offsets[genome])) {
+                    break;
+                }
+                pending.pop_front();
+                worker.jobs.push_back({genome, now});
+                progress = true;
+            }
+        }
+
+        if (!progress) std::this_thread::yield();
+    }
+}
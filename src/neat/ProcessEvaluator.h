@@ -0,0 +1,133 @@
+#ifndef NEAT_PROCESSEVALUATOR_H
+#define NEAT_PROCESSEVALUATOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <sys/types.h>
+
+#include "NetworkGenome.h"
+#include "../utils/SharedMemory.h"
+
+/**
+ * Evaluates genomes in a pool of forked worker processes.
+ *
+ * Genomes are sent to workers encoded by GenomeCodec through a lock-free request ring in shared memory,
+ * fitness comes back through a lock-free completion ring, one pair of rings per worker.
+ * A worker that crashes (or exceeds timeout) is restarted and its unfinished genomes are sent again.
+ * A genome that keeps killing workers gets fitness 0 after max_attempts.
+ *
+ * Can be used as population evaluation: Population(..., std::ref(evaluator)).
+ * Workers are forked on first use, so evaluation may use anything set up before that (including the population).
+ */
+class ProcessEvaluator {
+private:
+    /**
+     * Genome sent to a worker.
+     */
+    struct Job {
+        int genome;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    struct Worker {
+        pid_t pid = -1;
+        SharedRing requests;
+        SharedRing completions;
+
+        /**
+         * Jobs sent to the worker in order they will be processed.
+         */
+        std::vector<Job> jobs;
+    };
+
+    std::unique_ptr<SharedMemory> memory;
+    std::vector<Worker> workers;
+
+    /**
+     * Population genomes are decoded into in workers.
+     */
+    Population *population = nullptr;
+
+    /**
+     * Create shared memory and fork all workers.
+     */
+    void start();
+
+    /**
+     * Reset rings of a worker and fork it. Throws std::system_error if it can't be forked.
+     * @param index index of the worker
+     */
+    void start_worker(int index);
+
+    /**
+     * Kill and reap a worker.
+     * @param index index of the worker
+     */
+    void stop_worker(int index);
+
+    /**
+     * Loop executed by worker processes. Never returns.
+     * @param index index of the worker
+     */
+    [[noreturn]] void work(int index);
+
+public:
+    int worker_count;
+
+    /**
+     * Capacity of each ring in bytes.
+     */
+    std::size_t ring_capacity = 1 << 20;
+
+    /**
+     * Maximal number of genomes queued at a single worker.
+     */
+    int jobs_per_worker = 4;
+
+    /**
+     * Time after which an evaluation is considered stuck and its worker is restarted. (zero for no limit)
+     */
+    std::chrono::milliseconds timeout{0};
+
+    /**
+     * Number of times a genome is sent to a worker before giving up on it.
+     */
+    int max_attempts = 3;
+
+    /**
+     * Number of workers restarted so far.
+     */
+    long restarts = 0;
+
+    /**
+     * Function evaluating a single genome. Called in worker processes.
+     */
+    std::function<double(const NetworkGenome &)> evaluation;
+
+    /**
+     * @param worker_count number of worker processes
+     * @param evaluation function evaluating a single genome
+     */
+    ProcessEvaluator(int worker_count, std::function<double(const NetworkGenome &)> evaluation);
+
+    ProcessEvaluator(const ProcessEvaluator &) = delete;
+
+    ProcessEvaluator &operator=(const ProcessEvaluator &) = delete;
+
+    /**
+     * Kill all workers.
+     */
+    ~ProcessEvaluator();
+
+    /**
+     * Evaluate genomes, setting their fitness. Throws std::system_error if a worker can't be forked.
+     * @param genomes genomes to evaluate (all from the same population)
+     */
+    void operator()(std::vector<NetworkGenome> &genomes);
+};
+
+
+#endif //NEAT_PROCESSEVALUATOR_H
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <numeric>
+
+#include "Selection.h"
+
+void AliasTable::build(const std::vector<double> &weights) {
+    const int n = (int) weights.size();
+    probability.assign(n, 1.0);
+    alias.resize(n);
+    std::iota(alias.begin(), alias.end(), 0);
+    if (n == 0) return;
+
+    double total = 0;
+    for (double w: weights) {
+        total += std::max(0.0, w);
+    }
+    if (total <= 0) return;
+
+    // Scale weights so that their average is 1
+    std::vector<int> small;
+    std::vector<int> large;
+    for (int i = 0; i < n; i++) {
+        probability[i] = std::max(0.0, weights[i]) * n / total;
+        (probability[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    // Fill every underfull column with a part of an overfull one
+    while (!small.empty() && !large.empty()) {
+        int s = small.back();
+        small.pop_back();
+        int l = large.back();
+
+        alias[s] = l;
+        probability[l] -= 1.0 - probability[s];
+        if (probability[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // Remaining columns are full (up to rounding errors)
+    for (int i: small) probability[i] = 1.0;
+    for (int i: large) probability[i] = 1.0;
+}
+
+int AliasTable::sample(Random &engine) const {
+    double u = engine.uniform() * (double) probability.size();
+    int column = std::min((int) u, (int) probability.size() - 1);
+    return u - column < probability[column] ? column : alias[column];
+}
+
+int AliasTable::size() const {
+    return (int) probability.size();
+}
+
+void Selector::build(const std::vector<double> &candidate_fitness, SelectionMethod selection_method, int tournament) {
+    method = selection_method;
+    tournament_size = std::max(1, tournament);
+    fitness = candidate_fitness;
+
+    switch (method) {
+        case SelectionMethod::Uniform:
+        case SelectionMethod::Tournament:
+            table.build({});
+            break;
+        case SelectionMethod::FitnessProportional:
+            table.build(fitness);
+            break;
+        case SelectionMethod::Rank: {
+            // Worst candidate gets weight 1, best gets weight n
+            std::vector<int> order(fitness.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [this](int a, int b) { return fitness[a] < fitness[b]; });
+
+            std::vector<double> ranks(fitness.size());
+            for (int i = 0; i < (int) order.size(); i++) {
+                ranks[order[i]] = i + 1;
+            }
+            table.build(ranks);
+            break;
+        }
+    }
+}
+
+int Selector::select(Random &engine) const {
+    if (method == SelectionMethod::FitnessProportional || method == SelectionMethod::Rank) {
+        return table.sample(engine);
+    }
+
+    int chosen = engine.integer(size());
+    if (method == SelectionMethod::Tournament) {
+        for (int i = 1; i < tournament_size; i++) {
+            int candidate = engine.integer(size());
+            if (fitness[candidate] > fitness[chosen]) chosen = candidate;
+        }
+    }
+    return chosen;
+}
+
+int Selector::size() const {
+    return (int) fitness.size();
+}
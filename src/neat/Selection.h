@@ -0,0 +1,96 @@
+#ifndef NEAT_SELECTION_H
+#define NEAT_SELECTION_H
+
+#include <vector>
+
+#include "../utils/Random.h"
+
+/**
+ * Method of choosing parents based on fitness.
+ */
+enum class SelectionMethod {
+    Uniform,             /// every candidate has the same probability
+    FitnessProportional, /// probability proportional to fitness (roulette wheel)
+    Tournament,          /// best of tournament_size uniformly chosen candidates
+    Rank                 /// probability proportional to position in ordering by fitness
+};
+
+/**
+ * Walker alias table, used for sampling from a discrete distribution in constant time.
+ */
+class AliasTable {
+private:
+    /**
+     * Probability of choosing the column itself rather than its alias.
+     */
+    std::vector<double> probability;
+
+    /**
+     * Index chosen when the column is rejected.
+     */
+    std::vector<int> alias;
+
+public:
+    /**
+     * Build the table in linear time. Negative weights are treated as zero.
+     * If all weights are zero, every index has the same probability.
+     * @param weights weights of indices, not necessarily normalised
+     */
+    void build(const std::vector<double> &weights);
+
+    /**
+     * Choose a random index with probability proportional to its weight.
+     * Table must not be empty.
+     * @param engine random number engine
+     * @return chosen index
+     */
+    [[nodiscard]] int sample(Random &engine) const;
+
+    [[nodiscard]] int size() const;
+};
+
+/**
+ * Chooses candidates (genomes or species) based on their fitness using a given selection method.
+ *
+ * Selector is built once per generation, after which choosing a candidate takes constant time
+ * (or O(tournament_size) for tournament selection).
+ * Choosing doesn't modify the selector, so it can be shared by threads reproducing in parallel
+ * as long as each thread uses its own random engine.
+ */
+class Selector {
+private:
+    SelectionMethod method = SelectionMethod::FitnessProportional;
+    int tournament_size = 2;
+
+    /**
+     * Fitness of every candidate. (used by tournament selection)
+     */
+    std::vector<double> fitness;
+
+    /**
+     * Alias table over fitnesses or ranks. (used by fitness proportional and rank selection)
+     */
+    AliasTable table;
+
+public:
+    /**
+     * Prepare the selector for choosing from given candidates.
+     * @param candidate_fitness fitness of every candidate
+     * @param selection_method method of selection
+     * @param tournament tournament size (used only by tournament selection)
+     */
+    void build(const std::vector<double> &candidate_fitness, SelectionMethod selection_method, int tournament = 2);
+
+    /**
+     * Choose a random candidate.
+     * Selector must be built with at least one candidate.
+     * @param engine random number engine
+     * @return index of the chosen candidate
+     */
+    [[nodiscard]] int select(Random &engine) const;
+
+    [[nodiscard]] int size() const;
+};
+
+
+#endif //NEAT_SELECTION_H
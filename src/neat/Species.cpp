@@ -1,22 +1,24 @@
+#include <cmath>
 #include <iostream>
 #include "Species.h"
 
-bool Species::genome_compatible(NetworkGenome &genome) const {
+bool Species::genome_compatible(const NetworkGenome &genome) const {
     return NetworkGenome::get_compatibility_distance(genome, *representative,
                                                      genome.population.c1, genome.population.c2,
                                                      genome.population.c3) <= population->compatibility_threshold;
 }
 
-bool Species::insert_genome(NetworkGenome &genome) {
-    if (!genome_compatible(genome)) return false;
+bool Species::insert_genome(int index) {
+    if (!genome_compatible(population->genomes[index])) return false;
 
-    genomes.push_back(&genome);
+    genomes.push_back(index);
     return true;
 }
 
-Species::Species(NetworkGenome &genome) : population(&genome.population) {
-    representative = new NetworkGenome(genome);
-    genomes.push_back(&genome);
+Species::Species(Population &population, int index) : population(&population) {
+    // Representative outlives the generation, so it's not allocated in the arena
+    representative = new NetworkGenome(population.genomes[index], std::pmr::get_default_resource());
+    genomes.push_back(index);
 }
 
 Species::~Species() {
@@ -24,49 +26,76 @@ Species::~Species() {
 }
 
 Species::Species(const Species &species) : genomes(species.genomes), population(species.population),
-                                            representative(new NetworkGenome(*species.representative)) {
+                                            representative(new NetworkGenome(*species.representative)),
+                                            fitness(species.fitness), max_fitness(species.max_fitness),
+                                            generations_left(species.generations_left),
+                                            survival_cutoff(species.survival_cutoff),
+                                            selector(species.selector) {
 }
 
 void Species::normalise_fitness() {
     auto size = genomes.size();
     fitness = 0;
-    for(auto genome : genomes) {
-        fitness += genome->fitness;
-        genome->fitness /= (double)size;
+    for(int index : genomes) {
+        NetworkGenome &genome = population->genomes[index];
+        fitness += genome.fitness;
+        genome.fitness /= (double)size;
     }
     fitness /= (double)size;
 }
 
 const NetworkGenome *Species::random_genome() {
-    std::uniform_int_distribution<int> distribution(0, (int)genomes.size() - 1);
-    return genomes.at(distribution(population->random_generator));
+    return random_genome(population->random_generator);
+}
+
+const NetworkGenome *Species::random_genome(Random &engine) const {
+    return &population->genomes[genomes.at(selector.select(engine))];
 }
 
 Species &Species::operator=(const Species &species) {
     if (this == &species) return *this;
     population = species.population;
+    delete representative;
     representative = new NetworkGenome(*species.representative);
     genomes = species.genomes;
     fitness = species.fitness;
+    max_fitness = species.max_fitness;
+    generations_left = species.generations_left;
+    survival_cutoff = species.survival_cutoff;
+    selector = species.selector;
     return *this;
 }
 
-void Species::get_offspring(int n, std::vector<NetworkGenome> &p) {
+void Species::get_offspring(int n, std::vector<NetworkGenome> &p, std::pmr::memory_resource *resource) {
     int non_crossover = (int)((double)n * population->non_crossover_breeding_rate);
 
     for(int i = 0; i < non_crossover; i++) {
-        p.push_back(*random_genome());
+        const NetworkGenome *parent = random_genome();
+        p.emplace_back(*parent, resource).set_lineage(parent->id);
     }
 
     for(int i = 0; i < n - non_crossover; i++) {
-        p.push_back(NetworkGenome::crossover(*random_genome(), *random_genome()));
+        p.push_back(NetworkGenome::crossover(*random_genome(), *random_genome(), resource));
     }
 }
 
 void Species::reduce_population() {
-    std::sort(genomes.begin(), genomes.end(), [](const NetworkGenome* genome1, const NetworkGenome* genome2) {
-        return (genome1->fitness - genome2->fitness) > 0;
+    const auto &population_genomes = population->genomes;
+    std::sort(genomes.begin(), genomes.end(), [&population_genomes](int index1, int index2) {
+        return (population_genomes[index1].fitness - population_genomes[index2].fitness) > 0;
     });
     int survivor_count = std::ceil((double)genomes.size() * population->selection_rate);
     genomes.erase(genomes.begin() + survivor_count, genomes.end());
+    survival_cutoff = population_genomes[genomes.back()].raw_fitness;
+
+    build_selector();
+}
+
+void Species::build_selector() {
+    std::vector<double> member_fitness;
+    member_fitness.reserve(genomes.size());
+    for (int index : genomes) {
+        member_fitness.push_back(population->genomes[index].fitness);
+    }
+    selector.build(member_fitness, population->selection_method, population->tournament_size);
 }
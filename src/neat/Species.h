@@ -1,10 +1,12 @@
 #ifndef NEAT_SPECIES_H
 #define NEAT_SPECIES_H
 
+#include <memory_resource>
 #include <vector>
 
 #include "Population.h"
 #include "NetworkGenome.h"
+#include "Selection.h"
 
 class Population;
 
@@ -17,16 +19,32 @@ class Species {
 public:
     Population *population;
     NetworkGenome *representative;
-    std::vector<NetworkGenome *> genomes;
+
+    /**
+     * Indices of member genomes in population genomes.
+     */
+    std::vector<int> genomes;
     double fitness = 0;
     double max_fitness = 0;
     int generations_left = 15;
 
+    /**
+     * Raw fitness of the worst genome that survived the last reduce_population, 0 before that.
+     * Genomes of the species evaluated below it will not be chosen as parents.
+     */
+    double survival_cutoff = 0;
+
+    /**
+     * Selector over member genomes, built by reduce_population.
+     */
+    Selector selector;
+
     /**
      * Create new species with a given representative
-     * @param genome species representative
+     * @param population population containing the species
+     * @param index index of the species representative in population genomes
      */
-    Species(NetworkGenome &genome);
+    Species(Population &population, int index);
 
     Species(const Species &species);
 
@@ -35,14 +53,14 @@ public:
      * @param genome
      * @return true if genome is compatible, false otherwise
      */
-    [[nodiscard]] bool genome_compatible(NetworkGenome &genome) const;
+    [[nodiscard]] bool genome_compatible(const NetworkGenome &genome) const;
 
     /**
      * Inserts a genome into the species if it is compatible
-     * @param genome
+     * @param index index of the genome in population genomes
      * @return true if genome was inserted, false otherwise
      */
-    bool insert_genome(NetworkGenome &genome);
+    bool insert_genome(int index);
 
     /**
      * Reduce fitness based on number of genomes in a species. (see NEAT paper)
@@ -51,21 +69,35 @@ public:
     void normalise_fitness();
 
     /**
-     * Choose a random genome in the species. (all genomes have the same probability)
+     * Choose a random genome in the species using population selection method.
+     * Selector must be built. (see reduce_population)
      * @return a random genome
      */
     const NetworkGenome *random_genome();
 
+    /**
+     * Choose a random genome in the species using given random engine. Safe to call from multiple threads.
+     * @param engine random number engine used by the calling thread
+     * @return a random genome
+     */
+    [[nodiscard]] const NetworkGenome *random_genome(Random &engine) const;
+
     /**
      * Adds n new genomes made from crossover of random members of this species.
      * @param n number of new genomes
      * @param p vector of genomes to add to
+     * @param resource memory resource genes of new genomes are allocated from
+     */
+    void get_offspring(int n, std::vector<NetworkGenome> &p, std::pmr::memory_resource *resource);
+
+    /**
+     * Build selector over current members using population selection method.
      */
-    void get_offspring(int n, std::vector<NetworkGenome> &p);
+    void build_selector();
 
     /**
      * Sort genomes by fitness.
-     * Remove the worst performing organisms.
+     * Remove the worst performing organisms, then build selector over the survivors.
      */
     void reduce_population();
 
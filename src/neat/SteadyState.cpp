@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "SteadyState.h"
+
+SteadyState::SteadyState(Population &population, std::function<double(const NetworkGenome &)> evaluation,
+                         ThreadPool &pool) : pool(pool), population(population), evaluation(std::move(evaluation)) {
+    auto &genomes = population.genomes;
+    pool.parallel_for((int) genomes.size(), [this, &genomes](int i) {
+        genomes[i].fitness = this->evaluation(genomes[i]);
+        genomes[i].raw_fitness = genomes[i].fitness;
+    });
+
+    // Initial genomes can be replaced right away
+    birth.assign(genomes.size(), -minimum_age);
+
+    population.speciate();
+    recalculate();
+}
+
+void SteadyState::run(int evaluations) {
+    int launched = 0;
+    int completed = 0;
+
+    auto launch = [this, &launched] {
+        auto job = std::make_unique<Evaluation>();
+        job->genome = breed();
+        submit(job.release());
+        launched++;
+    };
+
+    // Keep every thread busy
+    const int in_flight = std::min(evaluations, pool.thread_count() * evaluations_per_thread);
+    while (launched < in_flight) {
+        launch();
+    }
+
+    std::vector<Evaluation *> batch;
+    while (completed < launched) {
+        {
+            std::unique_lock lock(finished_mutex);
+            evaluation_finished.wait(lock, [this] { return !finished.empty(); });
+            batch.swap(finished);
+        }
+
+        for (Evaluation *job: batch) {
+            std::unique_ptr<Evaluation> done(job);
+            replace(*done);
+            completed++;
+
+            if (launched < evaluations) launch();
+        }
+        batch.clear();
+    }
+}
+
+std::unique_ptr<NetworkGenome> SteadyState::breed() {
+    // Species fitness changes with every replacement, member fitness only in the replaced species
+    if (species_selector_stale) {
+        population.build_species_selector();
+        species_selector_stale = false;
+    }
+    Species &species = population.random_species();
+    SpeciesState &state = species_state[&species - population.species.data()];
+    if (state.selector_stale) {
+        species.build_selector();
+        state.selector_stale = false;
+    }
+
+    std::unique_ptr<NetworkGenome> child;
+    if (species.genomes.size() > 1 && !population.random_generator.bernoulli(population.non_crossover_breeding_rate)) {
+        const NetworkGenome *parent1 = species.random_genome();
+        const NetworkGenome *parent2 = species.random_genome();
+        if (parent2->fitness > parent1->fitness) std::swap(parent1, parent2);
+        child = std::make_unique<NetworkGenome>(NetworkGenome::crossover(*parent1, *parent2));
+    } else {
+        const NetworkGenome *parent = species.random_genome();
+        child = std::make_unique<NetworkGenome>(*parent);
+        child->set_lineage(parent->id);
+    }
+
+    population.mutate_genome(*child);
+    return child;
+}
+
+void SteadyState::submit(Evaluation *job) {
+    pool.submit([this, job] {
+        job->fitness = evaluation(*job->genome);
+
+        // Notify under the lock, run may return as soon as it sees the last job
+        std::lock_guard lock(finished_mutex);
+        finished.push_back(job);
+        evaluation_finished.notify_one();
+    });
+}
+
+int SteadyState::worst_genome() const {
+    int worst = -1;
+    int youngest_worst = -1;
+    double worst_fitness = 0;
+    double youngest_worst_fitness = 0;
+
+    for (std::size_t s = 0; s < species_state.size(); s++) {
+        const double size = (double) population.species[s].genomes.size();
+
+        // Shared fitness keeps the order within a species, so the first old enough member is its candidate.
+        // At most minimum_age genomes are young, so few members are skipped in total.
+        bool young_seen = false;
+        for (auto [key, index]: species_state[s].members) {
+            if (&population.genomes[index] == population.best) continue;
+
+            double shared_fitness = key / size;
+            if (replacements - birth[index] >= minimum_age) {
+                if (worst == -1 || shared_fitness < worst_fitness) {
+                    worst = index;
+                    worst_fitness = shared_fitness;
+                }
+                break;
+            }
+            if (!young_seen && (youngest_worst == -1 || shared_fitness < youngest_worst_fitness)) {
+                youngest_worst = index;
+                youngest_worst_fitness = shared_fitness;
+            }
+            young_seen = true;
+        }
+    }
+
+    // If every genome is too young, replace the worst one anyway
+    return worst != -1 ? worst : youngest_worst;
+}
+
+void SteadyState::replace(const Evaluation &job) {
+    int index = worst_genome();
+    remove_from_species(index);
+
+    // Genes are copied into the population arena, along with id, parents and objectives
+    NetworkGenome &genome = population.genomes[index];
+    total_fitness -= genome.fitness;
+    genome = *job.genome;
+    genome.fitness = job.fitness;
+    genome.raw_fitness = job.fitness;
+    birth[index] = replacements;
+    add_to_species(index);
+
+    // The best genome is never replaced, so the best fitness only grows
+    total_fitness += genome.fitness;
+    population.average_fitness = total_fitness / (double) population.genomes.size();
+    if (genome.fitness > population.best_fitness) {
+        population.best = &genome;
+        population.best_fitness = genome.fitness;
+    }
+
+    // Replaced genes stay in the arena until it is compacted
+    if (++replacements % (long) population.genomes.size() == 0) {
+        population.compact();
+        recalculate();
+    }
+}
+
+void SteadyState::add_to_species(int index) {
+    int s = population.insert_into_species(index);
+    if (s == (int) species_state.size()) {
+        species_state.emplace_back();
+        species_selector_stale = true;
+    }
+    population.genome_species[index] = s;
+
+    Species &species = population.species[s];
+    SpeciesState &state = species_state[s];
+    double fitness = population.genomes[index].fitness;
+    state.members.emplace(fitness_key(fitness), index);
+    state.total_fitness += fitness;
+    state.selector_stale = true;
+    species.fitness = state.total_fitness / (double) species.genomes.size();
+    species.max_fitness = std::max(species.max_fitness, fitness);
+    species_selector_stale = true;
+}
+
+void SteadyState::remove_from_species(int index) {
+    const int s = population.genome_species[index];
+    population.genome_species[index] = -1;
+    Species &species = population.species[s];
+    SpeciesState &state = species_state[s];
+
+    species.genomes.erase(std::find(species.genomes.begin(), species.genomes.end(), index));
+    species_selector_stale = true;
+    if (species.genomes.empty()) {
+        // Indices of later species shift, rare enough to update every genome
+        population.species.erase(population.species.begin() + s);
+        species_state.erase(species_state.begin() + s);
+        for (int &genome_species: population.genome_species) {
+            if (genome_species > s) genome_species--;
+        }
+        return;
+    }
+
+    double fitness = population.genomes[index].fitness;
+    state.members.erase({fitness_key(fitness), index});
+    state.selector_stale = true;
+    if (std::isfinite(fitness)) {
+        state.total_fitness -= fitness;
+    } else {
+        // Infinite fitness can't be subtracted back out of the sum
+        state.total_fitness = 0;
+        for (int member: species.genomes) {
+            state.total_fitness += population.genomes[member].fitness;
+        }
+    }
+    species.fitness = state.total_fitness / (double) species.genomes.size();
+}
+
+void SteadyState::recalculate() {
+    species_state.assign(population.species.size(), SpeciesState());
+    for (std::size_t s = 0; s < species_state.size(); s++) {
+        Species &species = population.species[s];
+        SpeciesState &state = species_state[s];
+        for (int index: species.genomes) {
+            double fitness = population.genomes[index].fitness;
+            state.members.emplace(fitness_key(fitness), index);
+            state.total_fitness += fitness;
+            if (fitness > species.max_fitness) species.max_fitness = fitness;
+        }
+        species.fitness = state.total_fitness / (double) species.genomes.size();
+    }
+    species_selector_stale = true;
+
+    population.best_fitness = -1;
+    total_fitness = 0;
+    for (const auto &genome: population.genomes) {
+        if (genome.fitness > population.best_fitness) {
+            population.best = &genome;
+            population.best_fitness = genome.fitness;
+        }
+        total_fitness += genome.fitness;
+    }
+    population.average_fitness = total_fitness / (double) population.genomes.size();
+}
+
+double SteadyState::fitness_key(double fitness) {
+    return std::isnan(fitness) ? -std::numeric_limits<double>::infinity() : fitness;
+}
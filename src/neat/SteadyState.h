@@ -0,0 +1,171 @@
+#ifndef NEAT_STEADYSTATE_H
+#define NEAT_STEADYSTATE_H
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "Population.h"
+#include "../utils/ThreadPool.h"
+
+/**
+ * Steady-state (rtNEAT style) evolution of a population.
+ *
+ * Instead of evaluating whole generations, offspring are evaluated asynchronously on a thread pool.
+ * Every finished evaluation replaces the worst individual (by fitness shared within its species) that is old enough,
+ * and a new offspring is sent for evaluation, so threads never wait for the slowest evaluation of a generation.
+ * Speciation and fitness sharing are updated incrementally with each replacement: a replacement touches only the two
+ * species involved and the selector over species, never every genome.
+ *
+ * In this mode genome fitness holds raw (unshared) fitness.
+ */
+class SteadyState {
+private:
+    /**
+     * Offspring sent for evaluation. Its genes live outside the population arena.
+     */
+    struct Evaluation {
+        std::unique_ptr<NetworkGenome> genome;
+        double fitness = 0;
+    };
+
+    ThreadPool &pool;
+
+    /**
+     * Finished evaluations waiting to be inserted into the population.
+     */
+    std::vector<Evaluation *> finished;
+    std::mutex finished_mutex;
+    std::condition_variable evaluation_finished;
+
+    /**
+     * Incrementally updated state of a species, kept parallel to population species.
+     */
+    struct SpeciesState {
+        /**
+         * Members ordered by fitness (NaN as -inf), then index.
+         */
+        std::set<std::pair<double, int>> members;
+
+        /**
+         * Sum of member fitnesses.
+         */
+        double total_fitness = 0;
+
+        /**
+         * Whether the selector of the species has to be rebuilt before choosing a parent.
+         */
+        bool selector_stale = true;
+    };
+
+    std::vector<SpeciesState> species_state;
+
+    /**
+     * Whether species fitness changed since the selector over species was built.
+     */
+    bool species_selector_stale = true;
+
+    /**
+     * Sum of fitnesses of all genomes.
+     */
+    double total_fitness = 0;
+
+    /**
+     * Value of replacements at the time each genome was inserted.
+     */
+    std::vector<long> birth;
+
+    /**
+     * Create an offspring of a species chosen based on species fitness.
+     * @return mutated offspring
+     */
+    std::unique_ptr<NetworkGenome> breed();
+
+    /**
+     * Send an offspring for evaluation on the thread pool.
+     * @param job evaluation to run (handed back through finished)
+     */
+    void submit(Evaluation *job);
+
+    /**
+     * Find the genome that should be replaced next.
+     * Looks at the worst members of every species, skipping only genomes younger than minimum_age and the best one.
+     * @return index of the genome with the lowest shared fitness among genomes at least minimum_age old
+     */
+    [[nodiscard]] int worst_genome() const;
+
+    /**
+     * Replace the worst genome with an evaluated offspring and update its species.
+     * @param job finished evaluation
+     */
+    void replace(const Evaluation &job);
+
+    /**
+     * Insert genome into a compatible species (or a new one) and update the fitness of that species.
+     * @param index index of the genome
+     */
+    void add_to_species(int index);
+
+    /**
+     * Remove genome from the species containing it and update the fitness of that species.
+     * Removes the species if it becomes empty.
+     * @param index index of the genome
+     */
+    void remove_from_species(int index);
+
+    /**
+     * Recalculate the state, average and maximal fitness of every species, and the best and average fitness of
+     * the population. Discards rounding errors accumulated by incremental updates.
+     */
+    void recalculate();
+
+    /**
+     * Key ordering members of a species, failed (NaN) evaluations first.
+     */
+    static double fitness_key(double fitness);
+
+public:
+    Population &population;
+
+    /**
+     * Function evaluating a single genome, called concurrently from pool threads.
+     */
+    std::function<double(const NetworkGenome &)> evaluation;
+
+    /**
+     * Number of replacements a genome has to survive before it can be replaced.
+     */
+    int minimum_age = 10;
+
+    /**
+     * Number of evaluations kept running per pool thread.
+     */
+    int evaluations_per_thread = 2;
+
+    /**
+     * Number of replacements done so far.
+     */
+    long replacements = 0;
+
+    /**
+     * Evaluate all genomes of the population with evaluation and speciate them.
+     * @param population population to evolve
+     * @param evaluation function evaluating a single genome (must be thread safe)
+     * @param pool thread pool used for evaluation
+     */
+    SteadyState(Population &population, std::function<double(const NetworkGenome &)> evaluation, ThreadPool &pool);
+
+    /**
+     * Run given number of evaluations, replacing a genome after each one.
+     * Returns when all of them are finished.
+     * @param evaluations number of offspring to evaluate
+     */
+    void run(int evaluations);
+};
+
+
+#endif //NEAT_STEADYSTATE_H
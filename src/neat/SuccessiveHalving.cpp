@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "SuccessiveHalving.h"
+
+SuccessiveHalving::SuccessiveHalving(std::vector<Fidelity> fidelities, Evaluation evaluation)
+        : evaluation(std::move(evaluation)), fidelities(std::move(fidelities)) {
+    if (this->fidelities.empty()) {
+        throw std::invalid_argument("No fidelities given");
+    }
+    evaluations.assign(this->fidelities.size(), 0);
+}
+
+void SuccessiveHalving::score_rung() {
+    const int n = (int) rung.size();
+    score.resize(n);
+
+    if (rung.front()->objectives.empty()) {
+        for (int i = 0; i < n; i++) {
+            score[i] = rung[i]->fitness;
+        }
+        return;
+    }
+
+    const int dimensions = (int) rung.front()->objectives.size();
+    objective_buffer.clear();
+    for (const NetworkGenome *genome: rung) {
+        if ((int) genome->objectives.size() != dimensions) {
+            throw std::invalid_argument("Genomes have different numbers of objectives");
+        }
+        for (double objective: genome->objectives) {
+            objective_buffer.push_back(std::isnan(objective) ? -std::numeric_limits<double>::infinity() : objective);
+        }
+    }
+    pareto.sort(objective_buffer.data(), n, dimensions);
+    for (int i = 0; i < n; i++) {
+        double crowding = pareto.crowding[i];
+        score[i] = -pareto.ranks[i] + (std::isinf(crowding) ? 0.5 : 0.5 * crowding / (1 + crowding));
+    }
+}
+
+void SuccessiveHalving::operator()(std::vector<NetworkGenome> &genomes) {
+    if (genomes.empty()) return;
+
+    rung.clear();
+    for (auto &genome: genomes) {
+        rung.push_back(&genome);
+    }
+    steps_full += (long) genomes.size() * fidelities.back().steps;
+
+    for (int level = 0; level < (int) fidelities.size(); level++) {
+        evaluation(rung, fidelities[level]);
+        for (NetworkGenome *genome: rung) {
+            genome->fidelity = level;
+        }
+        evaluations[level] += (long) rung.size();
+        steps_run += (long) rung.size() * fidelities[level].steps;
+
+        if (level + 1 == (int) fidelities.size()) break;
+
+        int promoted = std::max(min_promoted, (int) std::ceil((double) rung.size() / eta));
+        if (promoted >= (int) rung.size()) continue;
+
+        // Keep the best genomes, in their original order
+        score_rung();
+        order.resize(rung.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::nth_element(order.begin(), order.begin() + promoted, order.end(), [this](int a, int b) {
+            return score[a] > score[b];
+        });
+        order.resize(promoted);
+        std::sort(order.begin(), order.end());
+        for (int i = 0; i < promoted; i++) {
+            rung[i] = rung[order[i]];
+        }
+        rung.resize(promoted);
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef NEAT_SUCCESSIVEHALVING_H
+#define NEAT_SUCCESSIVEHALVING_H
+
+#include <functional>
+#include <vector>
+
+#include "NetworkGenome.h"
+#include "Pareto.h"
+
+/**
+ * Settings of a simulated evaluation. Cheaper fidelities simulate fewer, longer steps with fewer
+ * constraint iterations.
+ */
+struct Fidelity {
+    int steps;
+    double delta;
+    int constraint_iterations;
+};
+
+/**
+ * Multi-fidelity evaluation using successive halving.
+ *
+ * All genomes are evaluated at the first (cheapest) fidelity, then the best 1 / eta of them are promoted
+ * and evaluated at the next fidelity, and so on up to the last fidelity. Genomes keep fitness (or objectives)
+ * of the highest fidelity they reached, recorded in NetworkGenome::fidelity, so fidelities should measure
+ * comparable quantities (for example the same simulated time).
+ * Genomes with objectives are ranked by Pareto front and crowding distance.
+ *
+ * Can be used as population evaluation: Population(..., std::ref(successive_halving)).
+ */
+class SuccessiveHalving {
+public:
+    /**
+     * Function evaluating given genomes at a fidelity (setting their fitness or objectives).
+     */
+    using Evaluation = std::function<void(std::vector<NetworkGenome *> &, const Fidelity &)>;
+
+private:
+    Evaluation evaluation;
+
+    /**
+     * Genomes evaluated at the current fidelity.
+     */
+    std::vector<NetworkGenome *> rung;
+
+    std::vector<double> score;
+    std::vector<int> order;
+    std::vector<double> objective_buffer;
+    ParetoSort pareto;
+
+    /**
+     * Calculate score of genomes in rung, used to choose the promoted ones.
+     */
+    void score_rung();
+
+public:
+    /**
+     * Fidelities from the cheapest to the most accurate.
+     */
+    std::vector<Fidelity> fidelities;
+
+    /**
+     * Reduction factor, 1 / eta of genomes are promoted to the next fidelity.
+     */
+    double eta = 3;
+    int min_promoted = 1;
+
+    /**
+     * Number of genome evaluations at each fidelity.
+     */
+    std::vector<long> evaluations;
+
+    /**
+     * Simulation steps taken, and steps evaluating every genome at the last fidelity would take.
+     */
+    long steps_run = 0;
+    long steps_full = 0;
+
+    /**
+     * Create scheduler.
+     * @param fidelities fidelities from the cheapest to the most accurate, must not be empty
+     * @param evaluation function evaluating genomes at a fidelity
+     */
+    SuccessiveHalving(std::vector<Fidelity> fidelities, Evaluation evaluation);
+
+    /**
+     * Evaluate all genomes.
+     * @param genomes genomes to evaluate
+     */
+    void operator()(std::vector<NetworkGenome> &genomes);
+};
+
+#endif
@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "Surrogate.h"
+#include "Population.h"
+
+namespace {
+    /**
+     * Get evaluated targets of a genome.
+     * @param genome evaluated genome
+     * @param fitness fitness of the genome (used if it has no objectives)
+     * @param targets output, target_count values
+     * @param target_count number of targets
+     * @param objectives whether targets are objectives
+     * @return false if the genome has a different number of targets
+     */
+    bool genome_targets(const NetworkGenome &genome, double fitness, double *targets, int target_count,
+                        bool objectives) {
+        if (!objectives) {
+            targets[0] = fitness;
+            return true;
+        }
+        if ((int) genome.objectives.size() != target_count) return false;
+        std::copy(genome.objectives.begin(), genome.objectives.end(), targets);
+        return true;
+    }
+}
+
+bool Surrogate::ready() const {
+    return target_count > 0 && samples >= warmup_samples;
+}
+
+void Surrogate::initialise(int objective_count) {
+    uses_objectives = objective_count > 0;
+    target_count = uses_objectives ? objective_count : 1;
+    feature_count = 6 + 2 * target_count;
+    samples = 0;
+
+    weights.assign((std::size_t) target_count * feature_count, 0);
+    inverse_correlation.assign((std::size_t) feature_count * feature_count, 0);
+    for (int i = 0; i < feature_count; i++) {
+        inverse_correlation[i * feature_count + i] = 1 / ridge;
+    }
+}
+
+void Surrogate::calculate_features(const Population &population) {
+    const auto &genomes = population.genomes;
+    const auto &previous = population.next_genomes;
+
+    previous_ids.clear();
+    for (int i = 0; i < (int) previous.size(); i++) {
+        previous_ids.emplace_back(previous[i].id, i);
+    }
+    std::sort(previous_ids.begin(), previous_ids.end());
+
+    auto find_previous = [this, &previous](long id) -> const NetworkGenome * {
+        auto it = std::lower_bound(previous_ids.begin(), previous_ids.end(), std::make_pair(id, 0));
+        if (it == previous_ids.end() || it->first != id) return nullptr;
+        return &previous[it->second];
+    };
+
+    features.assign(genomes.size() * feature_count, 0);
+    for (int i = 0; i < (int) genomes.size(); i++) {
+        const NetworkGenome &genome = genomes[i];
+        double *x = &features[(std::size_t) i * feature_count];
+        x[0] = 1;
+
+        // Unchanged copies (champions) keep their id, so they are their own parent
+        const NetworkGenome *parent1 = find_previous(genome.id);
+        const NetworkGenome *parent2 = nullptr;
+        if (parent1 == nullptr) {
+            parent1 = find_previous(genome.parents[0]);
+            parent2 = find_previous(genome.parents[1]);
+        }
+        if (parent2 == nullptr) parent2 = parent1;
+
+        if (parent1 == nullptr
+            || !genome_targets(*parent1, parent1->raw_fitness, x + 2, target_count, uses_objectives)
+            || !genome_targets(*parent2, parent2->raw_fitness, x + 2 + target_count, target_count,
+                                uses_objectives)) {
+            std::fill(x + 2, x + 2 + 2 * target_count, 0);
+            continue;
+        }
+
+        x[1] = 1;
+        x[2 + 2 * target_count] = genome.parents[1] != -1 ? 1 : 0;
+        x[3 + 2 * target_count] = NetworkGenome::get_compatibility_distance(genome, *parent1, population.c1,
+                                                                            population.c2, population.c3);
+        x[4 + 2 * target_count] = (double) genome.genome.size() - (double) parent1->genome.size();
+    }
+
+    // Average fitness of first parents in a species
+    for (const auto &s: population.species) {
+        double total = 0;
+        int count = 0;
+        for (int index: s.genomes) {
+            const double *x = &features[(std::size_t) index * feature_count];
+            if (x[1] != 0) {
+                total += x[2];
+                count++;
+            }
+        }
+        double average = count > 0 ? total / count : 0;
+        for (int index: s.genomes) {
+            features[(std::size_t) index * feature_count + 5 + 2 * target_count] = average;
+        }
+    }
+}
+
+void Surrogate::predict(int index) {
+    const double *x = &features[(std::size_t) index * feature_count];
+    for (int t = 0; t < target_count; t++) {
+        const double *w = &weights[(std::size_t) t * feature_count];
+        double prediction = 0;
+        for (int i = 0; i < feature_count; i++) {
+            prediction += w[i] * x[i];
+        }
+        predictions[(std::size_t) index * target_count + t] = prediction;
+    }
+}
+
+void Surrogate::update(int index, const double *targets) {
+    const double *x = &features[(std::size_t) index * feature_count];
+    const int n = feature_count;
+
+    // Gain vector k = P x / (forgetting + x' P x)
+    std::vector<double> gain(n, 0);
+    double denominator = forgetting;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            gain[i] += inverse_correlation[i * n + j] * x[j];
+        }
+        denominator += x[i] * gain[i];
+    }
+
+    for (int t = 0; t < target_count; t++) {
+        double *w = &weights[(std::size_t) t * n];
+        double error = targets[t];
+        for (int i = 0; i < n; i++) {
+            error -= w[i] * x[i];
+        }
+        for (int i = 0; i < n; i++) {
+            w[i] += gain[i] * error / denominator;
+        }
+    }
+
+    // P = (P - k x' P) / forgetting, P is symmetric so x' P = (P x)'
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            inverse_correlation[i * n + j] =
+                    (inverse_correlation[i * n + j] - gain[i] * gain[j] / denominator) / forgetting;
+        }
+    }
+    samples++;
+}
+
+void Surrogate::evaluate_genomes(Population &population, const std::vector<int> &indices) {
+    auto &genomes = population.genomes;
+    auto start = std::chrono::steady_clock::now();
+
+    if (indices.size() == genomes.size()) {
+        population.evaluation(genomes);
+    } else {
+        // Evaluation works on a vector of genomes, so evaluate copies and copy results back
+        std::vector<NetworkGenome> batch;
+        batch.reserve(indices.size());
+        for (int index: indices) {
+            batch.emplace_back(genomes[index]);
+        }
+        population.evaluation(batch);
+        for (int i = 0; i < (int) indices.size(); i++) {
+            genomes[indices[i]].fitness = batch[i].fitness;
+            genomes[indices[i]].objectives = std::move(batch[i].objectives);
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    seconds_evaluating += seconds;
+    evaluated += (long) indices.size();
+    if (!indices.empty()) {
+        seconds_per_genome = seconds / (double) indices.size();
+    }
+
+    if (target_count == 0) {
+        initialise((int) genomes[indices.front()].objectives.size());
+    }
+    if (features.size() != genomes.size() * feature_count) {
+        calculate_features(population);
+    }
+    predictions.resize(genomes.size() * target_count);
+
+    // Accuracy of predictions made before learning from this generation
+    double error_sum = 0, sum_p = 0, sum_a = 0, sum_pp = 0, sum_aa = 0, sum_pa = 0;
+    int count = 0;
+    std::vector<double> targets(target_count);
+    for (int index: indices) {
+        if (!genome_targets(genomes[index], genomes[index].fitness, targets.data(), target_count,
+                            uses_objectives)) continue;
+        if (!std::all_of(targets.begin(), targets.end(), [](double v) { return std::isfinite(v); })) continue;
+
+        predict(index);
+        double predicted = predictions[(std::size_t) index * target_count];
+        double actual = targets[0];
+        error_sum += std::abs(predicted - actual);
+        sum_p += predicted;
+        sum_a += actual;
+        sum_pp += predicted * predicted;
+        sum_aa += actual * actual;
+        sum_pa += predicted * actual;
+        count++;
+
+        update(index, targets.data());
+    }
+
+    if (count > 0) {
+        error = error_sum / count;
+        double covariance = sum_pa - sum_p * sum_a / count;
+        double variance_p = sum_pp - sum_p * sum_p / count;
+        double variance_a = sum_aa - sum_a * sum_a / count;
+        correlation = variance_p > 0 && variance_a > 0 ? covariance / std::sqrt(variance_p * variance_a) : 0;
+    }
+}
+
+bool Surrogate::predicted(int index) const {
+    return enabled && index >= 0 && index < (int) predicted_genomes.size() && predicted_genomes[index];
+}
+
+void Surrogate::mark_evaluated(int index) {
+    if (index >= 0 && index < (int) predicted_genomes.size()) predicted_genomes[index] = false;
+}
+
+void Surrogate::evaluate(Population &population) {
+    auto &genomes = population.genomes;
+    const int n = (int) genomes.size();
+    features.clear();
+    predicted_genomes.assign(n, false);
+
+    std::vector<int> indices(n);
+    for (int i = 0; i < n; i++) {
+        indices[i] = i;
+    }
+
+    if (!ready()) {
+        evaluate_genomes(population, indices);
+        return;
+    }
+
+    calculate_features(population);
+    predictions.resize((std::size_t) n * target_count);
+    for (int i = 0; i < n; i++) {
+        predict(i);
+    }
+
+    // Score genomes by prediction, by predicted Pareto front for multiple objectives
+    std::vector<double> score(n);
+    if (target_count == 1) {
+        score = predictions;
+    } else {
+        pareto.sort(predictions.data(), n, target_count);
+        for (int i = 0; i < n; i++) {
+            double crowding = pareto.crowding[i];
+            score[i] = -pareto.ranks[i] + (std::isinf(crowding) ? 0.5 : 0.5 * crowding / (1 + crowding));
+        }
+    }
+    std::sort(indices.begin(), indices.end(), [&score](int a, int b) {
+        return score[a] > score[b];
+    });
+
+    int top = std::min(n, (int) std::ceil(evaluated_fraction * n));
+    int exploration = std::min(n - top, (int) std::round(exploration_fraction * n));
+    std::shuffle(indices.begin() + top, indices.end(), population.random_generator);
+
+    std::vector<int> chosen(indices.begin(), indices.begin() + top + exploration);
+    evaluate_genomes(population, chosen);
+
+    // Remaining genomes get predicted fitness
+    for (auto it = indices.begin() + top + exploration; it != indices.end(); it++) {
+        NetworkGenome &genome = genomes[*it];
+        predicted_genomes[*it] = true;
+        predict(*it);
+        const double *predicted = &predictions[(std::size_t) *it * target_count];
+        if (!uses_objectives) {
+            genome.fitness = std::max(0.0, predicted[0]);
+        } else {
+            genome.objectives.assign(predicted, predicted + target_count);
+        }
+    }
+    skipped += n - top - exploration;
+    seconds_saved += (double) (n - top - exploration) * seconds_per_genome;
+}
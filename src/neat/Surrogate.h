@@ -0,0 +1,184 @@
+#ifndef NEAT_SURROGATE_H
+#define NEAT_SURROGATE_H
+
+#include <utility>
+#include <vector>
+
+#include "Pareto.h"
+
+class Population;
+
+class NetworkGenome;
+
+/**
+ * Surrogate model predicting fitness of offspring, so that only promising ones have to be evaluated.
+ *
+ * Features of a genome are fitness of its parents (from the previous generation), whether it is a crossover,
+ * compatibility distance and gene count difference to its first parent (which measure the mutations applied),
+ * and the average parent fitness in its species. Targets are the objectives if the evaluation sets them,
+ * fitness otherwise. The model is a linear regression trained online with recursive least squares,
+ * on every genome that is really evaluated.
+ *
+ * Until warmup_samples genomes are evaluated, the whole population is evaluated. Afterwards only the
+ * evaluated_fraction with the best predictions, and an exploration_fraction chosen randomly from the rest,
+ * are evaluated. Other genomes get predicted fitness (or objectives), but never become the best genome of the
+ * population, so an unverified prediction isn't kept as the elite or reported as the best fitness.
+ */
+class Surrogate {
+private:
+    /**
+     * Number of targets (objectives, or 1 for fitness), 0 before the first evaluation.
+     */
+    int target_count = 0;
+
+    /**
+     * Whether targets are objectives rather than fitness.
+     */
+    bool uses_objectives = false;
+
+    /**
+     * Number of features. (see features)
+     */
+    int feature_count = 0;
+
+    /**
+     * Regression weights, feature_count per target.
+     */
+    std::vector<double> weights;
+
+    /**
+     * Inverse correlation matrix of recursive least squares, feature_count x feature_count.
+     */
+    std::vector<double> inverse_correlation;
+
+    /**
+     * Features of every genome of the current generation, feature_count per genome.
+     */
+    std::vector<double> features;
+
+    /**
+     * Predicted targets of every genome, target_count per genome.
+     */
+    std::vector<double> predictions;
+
+    /**
+     * Ids of genomes of the previous generation with their indices, sorted by id.
+     */
+    std::vector<std::pair<long, int>> previous_ids;
+
+    /**
+     * Orders genomes by predicted objectives.
+     */
+    ParetoSort pareto;
+
+    /**
+     * Average time of evaluating a single genome.
+     */
+    double seconds_per_genome = 0;
+
+    int samples = 0;
+
+    /**
+     * Whether each genome of the current generation got predicted rather than evaluated fitness.
+     */
+    std::vector<bool> predicted_genomes;
+
+    /**
+     * Set the number of targets and reset the model.
+     * @param objective_count number of objectives, 0 if fitness is the only target
+     */
+    void initialise(int objective_count);
+
+    /**
+     * Calculate features of all genomes.
+     * @param population evaluated population
+     */
+    void calculate_features(const Population &population);
+
+    /**
+     * Calculate predicted targets of a genome.
+     * @param index index of the genome
+     */
+    void predict(int index);
+
+    /**
+     * Update the model with a really evaluated genome.
+     * @param index index of the genome
+     * @param targets evaluated targets
+     */
+    void update(int index, const double *targets);
+
+    /**
+     * Evaluate given genomes with the evaluation of the population, measuring the time taken,
+     * then update the model and accuracy statistics.
+     * @param population evaluated population
+     * @param indices indices of genomes to evaluate
+     */
+    void evaluate_genomes(Population &population, const std::vector<int> &indices);
+
+public:
+    bool enabled = false;
+
+    double evaluated_fraction = 0.3;
+    double exploration_fraction = 0.1;
+    int warmup_samples = 500;
+
+    /**
+     * Forgetting factor of recursive least squares, older samples lose weight as genomes change.
+     */
+    double forgetting = 0.998;
+
+    /**
+     * Regularisation of the initial model.
+     */
+    double ridge = 1.0;
+
+    long evaluated = 0;  /// genomes really evaluated
+    long skipped = 0;    /// genomes given predicted fitness
+
+    /**
+     * Mean absolute error of predictions for genomes evaluated in the last generation (first target only).
+     */
+    double error = 0;
+
+    /**
+     * Correlation of predictions and evaluated fitness in the last generation (first target only).
+     */
+    double correlation = 0;
+
+    double seconds_evaluating = 0;
+
+    /**
+     * Estimated time the evaluation of skipped genomes would take.
+     */
+    double seconds_saved = 0;
+
+    /**
+     * Check whether the model has seen enough samples to skip evaluations.
+     * @return true if the model is trained
+     */
+    [[nodiscard]] bool ready() const;
+
+    /**
+     * Check whether a genome of the last evaluated generation got predicted fitness (or objectives).
+     * Population doesn't pick such genomes as the best genome or species champions.
+     * @param index index of the genome
+     * @return true if the genome wasn't evaluated
+     */
+    [[nodiscard]] bool predicted(int index) const;
+
+    /**
+     * Mark a genome as evaluated, after it was replaced by a genome with evaluated fitness.
+     * @param index index of the genome
+     */
+    void mark_evaluated(int index);
+
+    /**
+     * Evaluate the population, using the model to skip evaluating unpromising genomes once it is ready.
+     * Genomes must be speciated.
+     * @param population population to evaluate
+     */
+    void evaluate(Population &population);
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include <algorithm>
+
+#include "Behaviour.h"
+
+int Behaviour::final_positions_size(int point_count) {
+    return 2 * point_count;
+}
+
+void Behaviour::final_positions(const Creature &creature, double *behaviour) {
+    for (const auto &point: creature.points) {
+        *behaviour++ = point.position.x;
+        *behaviour++ = point.position.y;
+    }
+}
+
+int Behaviour::trajectory_size(int samples) {
+    return 2 * samples;
+}
+
+void Behaviour::trajectory(const Creature &creature, int samples, double *behaviour) {
+    const auto &trajectory = creature.trajectory;
+    for (int i = 0; i < samples; i++) {
+        Vector2D sample = trajectory.empty() ? creature.centre()
+                                             : trajectory[std::min(i, (int) trajectory.size() - 1)];
+        *behaviour++ = sample.x;
+        *behaviour++ = sample.y;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef NEAT_BEHAVIOUR_H
+#define NEAT_BEHAVIOUR_H
+
+#include "Creature.h"
+
+/**
+ * Behaviour descriptors of simulated creatures, used by novelty search.
+ */
+class Behaviour {
+public:
+    /**
+     * Calculate dimension of final_positions descriptor.
+     * @param point_count number of points of the creature
+     * @return number of values
+     */
+    static int final_positions_size(int point_count);
+
+    /**
+     * Describe a creature by final positions of its points.
+     * @param creature simulated creature
+     * @param behaviour array of final_positions_size values to fill
+     */
+    static void final_positions(const Creature &creature, double *behaviour);
+
+    /**
+     * Calculate dimension of trajectory descriptor.
+     * @param samples number of trajectory samples used
+     * @return number of values
+     */
+    static int trajectory_size(int samples);
+
+    /**
+     * Describe a creature by its sampled trajectory. (see Creature::trajectory_period)
+     * If fewer samples were taken, the last one is repeated.
+     * @param creature simulated creature
+     * @param samples number of samples to use
+     * @param behaviour array of trajectory_size values to fill
+     */
+    static void trajectory(const Creature &creature, int samples, double *behaviour);
+};
+
+
+#endif //NEAT_BEHAVIOUR_H
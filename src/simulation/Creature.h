@@ -1,38 +1,690 @@
 #ifndef NEAT_CREATURE_H
 #define NEAT_CREATURE_H
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
 #include <vector>
+
 #include "Point.h"
+#include "Recording.h"
+#include "SpatialHash.h"
 #include "Stick.h"
+#include "Terrain.h"
 #include "../utils/FastNetwork.h"
 
 /**
- * Class used for simulating creature physics.
+ * Class used for simulating creature physics, on a given scalar type (float or double).
+ *
+ * A controller network decides every decision_period. Its inputs are sensors (see sense): pressure and
+ * velocity of every point, direction of every stick and a bias. Its outputs set desired lengths of muscles.
+ * Buffers for sensors and network values are allocated with the creature, so decisions don't allocate.
+ * Networks always run in double.
  */
-class Creature {
+template<typename Scalar>
+class BasicCreature {
 public:
-    std::vector<Point> points;
-    std::vector<Stick> sticks;
+    using Vector = BasicVector2D<Scalar>;
+
+    std::vector<BasicPoint<Scalar>> points;
+
+    /**
+     * Sticks grouped by colour: sticks of one colour share no points, so solving one doesn't change the input
+     * of another and they can be solved in any order or at once. (see colour_sticks)
+     */
+    std::vector<BasicStick<Scalar>> sticks;
+
+    /**
+     * Index of the first stick of each colour in sticks, followed by the number of sticks.
+     */
+    std::vector<int> colour_offsets;
     FastNetwork network;
 
-    double decision_period = 0.1;
-    double time_until_decision = 0;
+    /**
+     * Network controlling the creature, either network or a network shared with other creatures.
+     */
+    const FastNetwork *controller = nullptr;
+
+    /**
+     * Node values of controller, owned by the creature.
+     */
+    std::vector<double> network_values;
+
+    /**
+     * Network inputs, filled by sense.
+     */
+    std::vector<double> sensor_values;
+
+    /**
+     * Indices of sticks whose desired length is set by the controller, in the order of network outputs.
+     * All sticks by default, in the order of their connections. (see set_muscles)
+     */
+    std::vector<int> muscles;
+
+    /**
+     * Desired length of each muscle when its output is 0.5.
+     */
+    std::vector<Scalar> rest_lengths;
+
+    /**
+     * Largest relative change of muscle length, reached at outputs 0 and 1.
+     */
+    Scalar muscle_strength = Scalar(0.25);
+
+    /**
+     * Ground under the creature, flat at height 0 if nullptr. Must outlive the creature.
+     */
+    const Terrain *terrain = nullptr;
+
+    /**
+     * Radius of points. If positive, points collide with each other and with sticks they are not ends of.
+     * (see collide)
+     */
+    Scalar collision_radius = 0;
+
+    /**
+     * Points by cells of size point_cell (twice collision_radius), so a point can only touch points in the 3x3
+     * cells around it. 0 until collisions are first solved.
+     */
+    SpatialHash point_hash;
+    Scalar point_cell = 0;
+
+    /**
+     * Midpoints of sticks by cells of size stick_cell (more than half of the longest stick plus collision_radius),
+     * so a point can only touch sticks with midpoints in the 3x3 cells around it. 0 until collisions are first
+     * solved.
+     */
+    SpatialHash stick_hash;
+    Scalar stick_cell = 0;
+
+    /**
+     * Points connected to each point by sticks, those of point i are neighbours[neighbour_offsets[i]] up to
+     * neighbours[neighbour_offsets[i + 1]]. Connected points don't collide.
+     */
+    std::vector<int> neighbour_offsets;
+    std::vector<int> neighbours;
+
+    /**
+     * Number of collisions solved so far.
+     */
+    long contacts = 0;
+
+    Scalar decision_period = Scalar(0.1);
+
+    /**
+     * Number of times stick constraints are solved every timestep, when constraint_tolerance is 0.
+     */
+    int constraint_iterations = 5;
+
+    /**
+     * Largest relative stick length error (see Stick::constrain_points) accepted after a timestep.
+     * If positive, sticks are solved until a sweep starts with all errors below it, at most
+     * max_constraint_iterations times. 0 always solves constraint_iterations times.
+     */
+    Scalar constraint_tolerance = 0;
+    int max_constraint_iterations = 20;
+
+    /**
+     * Number of timesteps that solved sticks a given number of times, indexed by that number.
+     */
+    std::vector<long> iteration_histogram;
+
+    /**
+     * Solve sticks with an approximate inverse square root. (see Stick::inverse_sqrt)
+     */
+    bool fast_inverse_sqrt = false;
+    Scalar time_until_decision = 0;
+
+    /**
+     * Sum of changes of muscle lengths.
+     */
+    Scalar energy_spent = 0;
+    Scalar highest_jump = 0;
+
+    /**
+     * Number of timesteps between trajectory samples (0 disables sampling).
+     */
+    int trajectory_period = 0;
+
+    /**
+     * Centre of the creature sampled every trajectory_period timesteps.
+     */
+    std::vector<Vector> trajectory;
+
+    /**
+     * Number of timesteps simulated so far.
+     */
+    int steps = 0;
+
+    /**
+     * If not nullptr, positions of points are recorded after every timestep. Record the initial pose before the
+     * first timestep to replay it too. Must outlive the creature. Copies of the creature don't record, frames
+     * of two creatures in one recording would be mixed.
+     */
+    Recording::Writer *recorder = nullptr;
+
+    [[nodiscard]] Scalar distance_ran() const {
+        return std::max_element(points.begin(), points.end(), [](const auto &p1, const auto &p2) {
+            return p1.position.x < p2.position.x;
+        })->position.x;
+    }
+
+    /**
+     * Calculate average position of points.
+     * @return centre of the creature
+     */
+    [[nodiscard]] Vector centre() const {
+        Vector sum;
+        for (const auto &point: points) {
+            sum += point.position;
+        }
+        return sum / (Scalar) points.size();
+    }
+
+    /**
+     * Calculate the largest absolute coordinate of a point, used to detect unstable simulation.
+     * @return largest absolute coordinate, infinity if any coordinate is not finite
+     */
+    [[nodiscard]] Scalar extent() const {
+        Scalar extent = 0;
+        for (const auto &point: points) {
+            if (!std::isfinite(point.position.x) || !std::isfinite(point.position.y)) {
+                return std::numeric_limits<Scalar>::infinity();
+            }
+            extent = std::max({extent, std::abs(point.position.x), std::abs(point.position.y)});
+        }
+        return extent;
+    }
+
+    BasicCreature(const std::vector<Vector2D> &points, const std::vector<std::pair<int, int>> &connections,
+                  const FastNetwork &network) : BasicCreature(points, connections) {
+        this->network = network;
+        controller = &this->network;
+        network_values.resize(network.node_count);
+    }
+
+    /**
+     * Number of network inputs of a creature: 3 per point, 2 per stick and a bias.
+     * @param point_count
+     * @param stick_count
+     * @return number of sensor values
+     */
+    static constexpr int sensor_count(int point_count, int stick_count) {
+        return 3 * point_count + 2 * stick_count + 1;
+    }
+
+    /**
+     * Create a creature controlled by a shared network, without copying it.
+     * @param points initial positions of points
+     * @param connections pairs of points connected with sticks
+     * @param shared_network network controlling the creature, must outlive it
+     */
+    BasicCreature(const std::vector<Vector2D> &points, const std::vector<std::pair<int, int>> &connections,
+                  const FastNetwork *shared_network) : BasicCreature(points, connections) {
+        attach(shared_network);
+    }
+
+    /**
+     * Create a creature placed on the ground. Points are converted to the scalar type of the creature.
+     * @param points initial positions of points
+     * @param connections pairs of points connected with sticks
+     */
+    BasicCreature(const std::vector<Vector2D> &points, const std::vector<std::pair<int, int>> &connections)
+            : network() {
+        for (const auto &p: points) {
+            this->points.emplace_back(Vector(p));
+        }
+        normalise_position();
+        for (const auto &[from, to]: connections) {
+            auto &p1 = this->points.at(from);
+            auto &p2 = this->points.at(to);
+            sticks.emplace_back(p1, p2, (p1.position - p2.position).length());
+        }
+        // Every connection is a muscle, in the order of connections rather than the colour order of sticks
+        std::vector<int> connection_sticks = colour_sticks();
+        find_neighbours();
+
+        sensor_values.resize(sensor_count((int) this->points.size(), (int) sticks.size()));
+        set_muscle_sticks(connection_sticks);
+    }
+
+    /**
+     * Choose muscles by the points they connect. Throws std::invalid_argument if there is no such stick.
+     * @param connections pairs of points connected by muscles, in the order of network outputs
+     */
+    void set_muscles(const std::vector<std::pair<int, int>> &connections) {
+        std::vector<int> indices;
+        for (const auto &[from, to]: connections) {
+            auto it = std::find_if(sticks.begin(), sticks.end(), [this, from, to](const auto &stick) {
+                const auto *first = &points.at(from);
+                const auto *second = &points.at(to);
+                return (stick.ends[0] == first && stick.ends[1] == second) ||
+                       (stick.ends[0] == second && stick.ends[1] == first);
+            });
+            if (it == sticks.end()) {
+                throw std::invalid_argument("Muscle is not a stick");
+            }
+            indices.push_back((int) (it - sticks.begin()));
+        }
+        set_muscle_sticks(indices);
+    }
+
+    /**
+     * Choose muscles by stick indices. Their current desired lengths become rest lengths.
+     * @param indices indices of sticks, in the order of network outputs
+     */
+    void set_muscle_sticks(const std::vector<int> &indices) {
+        muscles = indices;
+        rest_lengths.clear();
+        for (int stick: muscles) {
+            rest_lengths.push_back(sticks[stick].desired_length);
+        }
+    }
+
+    void timestep(Scalar delta) {
+        if (controller != nullptr && controller->input_count > 0 && (time_until_decision -= delta) <= 0) {
+            time_until_decision = decision_period;
+            take_action(delta);
+        }
+
+        for (auto &point: points) {
+            point.timestep(delta);
+        }
+
+        constrain_points(delta);
+
+        Scalar jump_height = (*std::min_element(points.begin(), points.end(), [](const auto &point1,
+                                                                                  const auto &point2) {
+            return point1.position.y < point2.position.y;
+        })).position.y;
+
+        if (jump_height > highest_jump) highest_jump = jump_height;
+
+        steps++;
+        if (trajectory_period > 0 && steps % trajectory_period == 0) {
+            trajectory.push_back(centre());
+        }
+        if (recorder != nullptr) {
+            recorder->record(points);
+        }
+    }
+
+    /**
+     * Solve stick constraints colour by colour (see constraint_tolerance), then push points out of the ground
+     * (see terrain).
+     * @param delta
+     */
+    void constrain_points(Scalar delta) {
+        int iterations = 0;
+        if (constraint_tolerance > 0) {
+            while (iterations < max_constraint_iterations) {
+                iterations++;
+                if (solve_sticks() < constraint_tolerance) break;
+            }
+        } else {
+            for (; iterations < constraint_iterations; iterations++) {
+                solve_sticks();
+            }
+        }
+
+        if ((int) iteration_histogram.size() <= iterations) iteration_histogram.resize(iterations + 1);
+        iteration_histogram[iterations]++;
+
+        if (collision_radius > 0) {
+            collide();
+        }
+
+        if (terrain == nullptr) {
+            for (auto &point: points) {
+                if (point.position.y < 0) {
+                    point.pressure = -point.position.y / delta;
+                    point.position.y = 0;
+                } else {
+                    point.pressure = 0;
+                }
+            }
+            return;
+        }
+
+        // Points below the ground are pushed straight up onto it
+        for (auto &point: points) {
+            Scalar ground = terrain->height(point.position.x);
+            if (point.position.y < ground) {
+                point.pressure = (ground - point.position.y) / delta;
+                point.position.y = ground;
+            } else {
+                point.pressure = 0;
+            }
+        }
+    }
+
+    /**
+     * Solve every stick once.
+     * @return largest relative stick length error before the sweep
+     */
+    Scalar solve_sticks() {
+        Scalar error = 0;
+        const int colour_count = (int) colour_offsets.size() - 1;
+        // Sticks of a colour are independent, so their square roots and divisions overlap
+        for (int colour = 0; colour < colour_count; colour++) {
+            for (int s = colour_offsets[colour]; s < colour_offsets[colour + 1]; s++) {
+                error = std::max(error, sticks[s].constrain_points(fast_inverse_sqrt));
+            }
+        }
+        return error;
+    }
+
+    /**
+     * Push apart points closer than twice collision_radius (unless a stick connects them), and points closer
+     * than collision_radius to a stick they are not ends of. Exploded creatures don't collide.
+     *
+     * Candidates come from point_hash and stick_hash, updated incrementally. Cells only change when
+     * collision_radius changes or a stick becomes too long for stick_cell, then the hash is rebuilt.
+     */
+    void collide() {
+        const int point_count = (int) points.size();
+        const int stick_count = (int) sticks.size();
+        const Scalar radius = collision_radius;
+
+        Scalar longest = 0;
+        for (const auto &stick: sticks) {
+            Vector d = stick.ends[1]->position - stick.ends[0]->position;
+            longest = std::max(longest, d.x * d.x + d.y * d.y);
+        }
+        const Scalar reach = std::sqrt(longest) / 2 + radius;
+        if (!std::isfinite(reach)) return;
+
+        if (point_cell != 2 * radius) {
+            point_cell = 2 * radius;
+            point_hash.clear(point_count);
+        }
+        if (reach > stick_cell) {
+            // With a margin, so slowly stretching sticks don't rebuild the hash every timestep
+            stick_cell = reach * Scalar(1.25);
+            stick_hash.clear(stick_count);
+        }
+
+        auto cell = [](Scalar coordinate, Scalar inverse_size) {
+            Scalar c = std::floor(coordinate * inverse_size);
+            return c > -1e9 && c < 1e9 ? (int) c : 0;
+        };
+        const Scalar inverse_point_cell = 1 / point_cell;
+        const Scalar inverse_stick_cell = 1 / stick_cell;
+        for (int i = 0; i < point_count; i++) {
+            const Vector &position = points[i].position;
+            point_hash.update(i, cell(position.x, inverse_point_cell), cell(position.y, inverse_point_cell));
+        }
+        for (int s = 0; s < stick_count; s++) {
+            Vector middle = (sticks[s].ends[0]->position + sticks[s].ends[1]->position) / 2;
+            stick_hash.update(s, cell(middle.x, inverse_stick_cell), cell(middle.y, inverse_stick_cell));
+        }
+
+        for (int i = 0; i < point_count; i++) {
+            auto &point = points[i];
+            point_hash.for_each_near(cell(point.position.x, inverse_point_cell),
+                                     cell(point.position.y, inverse_point_cell), [this, i](int j) {
+                if (j > i) collide_points(i, j);
+            });
+            stick_hash.for_each_near(cell(point.position.x, inverse_stick_cell),
+                                     cell(point.position.y, inverse_stick_cell), [this, &point](int s) {
+                auto &stick = sticks[s];
+                if (stick.ends[0] != &point && stick.ends[1] != &point) collide_point_stick(point, stick);
+            });
+        }
+    }
+
+    /**
+     * Push two points apart to twice collision_radius, each by half of the overlap.
+     * @param first index of a point
+     * @param second index of another point
+     */
+    void collide_points(int first, int second) {
+        Vector d = points[second].position - points[first].position;
+        Scalar squared = d.x * d.x + d.y * d.y;
+        Scalar reach = 2 * collision_radius;
+        if (!(squared < reach * reach) || squared == 0) return;
+        for (int n = neighbour_offsets[first]; n < neighbour_offsets[first + 1]; n++) {
+            if (neighbours[n] == second) return;
+        }
+
+        Scalar distance = std::sqrt(squared);
+        Vector push = d * ((reach - distance) / distance / 2);
+        points[first].position -= push;
+        points[second].position += push;
+        contacts++;
+    }
+
+    /**
+     * Push a point and a stick apart to collision_radius. Points have equal masses, so the push conserves
+     * momentum: the point moves against the closest point of the stick, weighted by their inverse masses.
+     * @param point
+     * @param stick
+     */
+    void collide_point_stick(BasicPoint<Scalar> &point, BasicStick<Scalar> &stick) {
+        Vector &a = stick.ends[0]->position;
+        Vector &b = stick.ends[1]->position;
+        const Vector &p = point.position;
+        const Scalar r = collision_radius;
+        // Most candidates are outside the bounding box of the stick
+        if (p.x < std::min(a.x, b.x) - r || p.x > std::max(a.x, b.x) + r ||
+            p.y < std::min(a.y, b.y) - r || p.y > std::max(a.y, b.y) + r) {
+            return;
+        }
+
+        Vector ab = b - a;
+        Scalar squared_length = ab.x * ab.x + ab.y * ab.y;
+        if (squared_length == 0) return;
+
+        Vector ap = point.position - a;
+        Scalar t = std::clamp((ap.x * ab.x + ap.y * ab.y) / squared_length, Scalar(0), Scalar(1));
+        Vector d = ap - ab * t;
+        Scalar squared = d.x * d.x + d.y * d.y;
+        if (!(squared < collision_radius * collision_radius) || squared == 0) return;
+
+        // Inverse masses of the point and the closest point of the stick (1 and (1 - t)² + t²) share the overlap,
+        // and the ends move by (1 - t) and t of the stick's share, so total momentum doesn't change
+        Scalar distance = std::sqrt(squared);
+        Vector correction = d * ((collision_radius - distance) / distance);
+        Scalar weight = 1 / (1 + (1 - t) * (1 - t) + t * t);
+        point.position += correction * weight;
+        a -= correction * ((1 - t) * weight);
+        b -= correction * (t * weight);
+        contacts++;
+    }
+
+    /**
+     * Calculate the current largest relative stick length error, without moving points.
+     * @return largest |length - desired_length| / length
+     */
+    [[nodiscard]] Scalar stick_error() const {
+        Scalar error = 0;
+        for (const auto &stick: sticks) {
+            Scalar length = (stick.ends[1]->position - stick.ends[0]->position).length();
+            error = std::max(error, std::abs(length - stick.desired_length) / length);
+        }
+        return error;
+    }
+
+    /**
+     * Colour sticks greedily in their order, so that sticks of the same colour share no points,
+     * then sort them by colour (keeping their order within a colour) and set colour_offsets.
+     * @return new index of each stick, in the previous order of sticks
+     */
+    std::vector<int> colour_sticks() {
+        // Colours used by sticks at each point
+        std::vector<std::vector<bool>> used(points.size());
+        std::vector<int> colours;
+        colours.reserve(sticks.size());
+        int colour_count = 0;
+        for (const auto &stick: sticks) {
+            auto &first = used[stick.ends[0] - points.data()];
+            auto &second = used[stick.ends[1] - points.data()];
+            int colour = 0;
+            while ((colour < (int) first.size() && first[colour]) || (colour < (int) second.size() && second[colour])) {
+                colour++;
+            }
+            for (auto *point_colours: {&first, &second}) {
+                if ((int) point_colours->size() <= colour) point_colours->resize(colour + 1);
+                (*point_colours)[colour] = true;
+            }
+            colours.push_back(colour);
+            colour_count = std::max(colour_count, colour + 1);
+        }
+
+        // Counting sort keeps the order of sticks within a colour
+        colour_offsets.assign(colour_count + 1, 0);
+        for (int colour: colours) {
+            colour_offsets[colour + 1]++;
+        }
+        for (int c = 0; c < colour_count; c++) {
+            colour_offsets[c + 1] += colour_offsets[c];
+        }
+        std::vector<BasicStick<Scalar>> sorted(sticks);
+        std::vector<int> next(colour_offsets.begin(), colour_offsets.end() - 1);
+        std::vector<int> indices(sticks.size());
+        for (int i = 0; i < (int) sticks.size(); i++) {
+            indices[i] = next[colours[i]]++;
+            sorted[indices[i]] = sticks[i];
+        }
+        sticks = std::move(sorted);
+        return indices;
+    }
+
+    /**
+     * Set neighbour_offsets and neighbours from sticks.
+     */
+    void find_neighbours() {
+        const int point_count = (int) points.size();
+        neighbour_offsets.assign(point_count + 1, 0);
+        for (const auto &stick: sticks) {
+            for (const auto *end: stick.ends) {
+                neighbour_offsets[end - points.data() + 1]++;
+            }
+        }
+        for (int p = 0; p < point_count; p++) {
+            neighbour_offsets[p + 1] += neighbour_offsets[p];
+        }
+        neighbours.resize(neighbour_offsets.back());
+        std::vector<int> next(neighbour_offsets.begin(), neighbour_offsets.end() - 1);
+        for (const auto &stick: sticks) {
+            const int first = (int) (stick.ends[0] - points.data());
+            const int second = (int) (stick.ends[1] - points.data());
+            neighbours[next[first]++] = second;
+            neighbours[next[second]++] = first;
+        }
+    }
+
+    void normalise_position() {
+        Scalar minx = points.front().position.x;
+        Scalar maxx = points.front().position.x;
+        Scalar miny = points.front().position.y;
+        for (const auto &p: points) {
+            if (p.position.x < minx) minx = p.position.x;
+            if (p.position.y < miny) miny = p.position.y;
+            if (p.position.x > maxx) maxx = p.position.x;
+        }
+        Scalar centerx = (minx + maxx) / 2;
+        for (auto &p: points) {
+            p.position.x -= centerx;
+            p.old_position.x -= centerx;
+            p.position.y -= miny;
+            p.old_position.y -= miny;
+        }
+    }
+
+    /**
+     * Fill sensor_values: pressure of every point, velocity of every point (x, y), direction of every stick
+     * (cosine and sine of its angle), then 1.
+     * @param delta timestep length, for velocities
+     */
+    void sense(Scalar delta) {
+        double *inputs = sensor_values.data();
+        for (const auto &point: points) {
+            *inputs++ = point.pressure;
+        }
+        for (const auto &point: points) {
+            *inputs++ = (point.position.x - point.old_position.x) / delta;
+            *inputs++ = (point.position.y - point.old_position.y) / delta;
+        }
+        for (const auto &stick: sticks) {
+            Vector direction = stick.ends[1]->position - stick.ends[0]->position;
+            Scalar length = direction.length();
+            *inputs++ = direction.x / length;
+            *inputs++ = direction.y / length;
+        }
+        *inputs = 1;
+    }
+
+    /**
+     * Read sensors, run the controller and set muscle lengths from its outputs.
+     * @param delta timestep length
+     */
+    void take_action(Scalar delta) {
+        sense(delta);
+        const double *outputs = controller->calculate(sensor_values.data(), network_values.data());
+        actuate(outputs);
+    }
 
-    double energy_spent = 0;
-    double highest_jump = 0;
+    /**
+     * Set muscle lengths from network outputs, output 0.5 keeps the rest length.
+     * @param outputs one value in [0, 1] per muscle
+     */
+    void actuate(const double *outputs) {
+        for (int m = 0; m < (int) muscles.size(); m++) {
+            auto &stick = sticks[muscles[m]];
+            Scalar length = rest_lengths[m] * (1 + muscle_strength * (Scalar) (2 * outputs[m] - 1));
+            energy_spent += std::abs(length - stick.desired_length);
+            stick.desired_length = length;
+        }
+    }
 
-    [[nodiscard]] double distance_ran() const;
-    Creature(const std::vector<Vector2D> &points, const std::vector<std::pair<int, int>> &connections, const FastNetwork &network);
-    Creature(const std::vector<Vector2D> &points, const std::vector<std::pair<int, int>> &connections);
+    /**
+     * Give the creature a shared network, reusing its buffers when they are large enough.
+     * @param shared_network network controlling the creature, must outlive it, nullptr for none
+     */
+    void attach(const FastNetwork *shared_network) {
+        controller = shared_network;
+        network_values.resize(shared_network != nullptr ? shared_network->node_count : 0);
+    }
 
-    void timestep(double delta);
-    void constrain_points(double delta);
-    void normalise_position();
-    void take_action();
+    /**
+     * Copy a creature. Sticks of the copy connect its own points, and if the creature owns its network, so does
+     * the copy. The copy doesn't record (see recorder).
+     * @param creature
+     */
+    BasicCreature(const BasicCreature &creature)
+            : points(creature.points), sticks(creature.sticks), colour_offsets(creature.colour_offsets), network(),
+              controller(creature.controller), network_values(creature.network_values),
+              sensor_values(creature.sensor_values), muscles(creature.muscles), rest_lengths(creature.rest_lengths),
+              muscle_strength(creature.muscle_strength), terrain(creature.terrain),
+              collision_radius(creature.collision_radius), point_hash(creature.point_hash),
+              point_cell(creature.point_cell), stick_hash(creature.stick_hash), stick_cell(creature.stick_cell),
+              neighbour_offsets(creature.neighbour_offsets), neighbours(creature.neighbours),
+              contacts(creature.contacts),
+              decision_period(creature.decision_period),
+              constraint_iterations(creature.constraint_iterations),
+              constraint_tolerance(creature.constraint_tolerance),
+              max_constraint_iterations(creature.max_constraint_iterations),
+              iteration_histogram(creature.iteration_histogram), fast_inverse_sqrt(creature.fast_inverse_sqrt),
+              time_until_decision(creature.time_until_decision), energy_spent(creature.energy_spent),
+              highest_jump(creature.highest_jump), trajectory_period(creature.trajectory_period),
+              trajectory(creature.trajectory), steps(creature.steps) {
+        for (auto &stick: sticks) {
+            for (auto &end: stick.ends) {
+                end = points.data() + (end - creature.points.data());
+            }
+        }
+        if (creature.controller == &creature.network) {
+            network = creature.network;
+            controller = &network;
+        }
+    }
 
-    Creature(const Creature&) = delete;
-    Creature(const Creature&&) = delete;
+    BasicCreature &operator=(const BasicCreature &) = delete;
 };
 
+using Creature = BasicCreature<double>;
 
 #endif //NEAT_CREATURE_H
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "CreatureBatch.h"
+
+template<typename Scalar>
+BasicCreatureBatch<Scalar>::BasicCreatureBatch(const BasicCreature<Scalar> &creature, int count)
+        : count(count), point_count((int) creature.points.size()), stick_count((int) creature.sticks.size()),
+          colour_offsets(creature.colour_offsets), terrain(creature.terrain), muscles(creature.muscles),
+          muscle_strength(creature.muscle_strength), decision_period(creature.decision_period),
+          constraint_iterations(creature.constraint_iterations),
+          constraint_tolerance(creature.constraint_tolerance),
+          max_constraint_iterations(creature.max_constraint_iterations),
+          fast_inverse_sqrt(creature.fast_inverse_sqrt) {
+    if (count <= 0) {
+        throw std::invalid_argument("Batch must have at least one lane");
+    }
+    if (creature.collision_radius > 0) {
+        throw std::invalid_argument("Batches don't simulate collisions");
+    }
+
+    const std::size_t size = (std::size_t) point_count * count;
+    for (auto *values: {&x, &y, &old_x, &old_y, &force_x, &force_y, &pressure, &ground}) {
+        values->resize(size);
+    }
+    desired_length.resize((std::size_t) stick_count * count);
+    rest_lengths.resize(muscles.size() * count);
+    controllers.resize(count);
+    network_values.resize(count);
+    time_until_decision.resize(count);
+    sensor_values.resize(creature.sensor_values.size());
+    highest_jump.resize(count);
+    energy_spent.resize(count);
+    lane_error.resize(count);
+
+    for (const auto &stick: creature.sticks) {
+        stick_ends.push_back((int) (stick.ends[0] - creature.points.data()));
+        stick_ends.push_back((int) (stick.ends[1] - creature.points.data()));
+    }
+
+    for (int lane = 0; lane < count; lane++) {
+        load(lane, creature);
+    }
+    steps = creature.steps;
+}
+
+template<typename Scalar>
+void BasicCreatureBatch<Scalar>::load(int lane, const BasicCreature<Scalar> &creature) {
+    if ((int) creature.points.size() != point_count || (int) creature.sticks.size() != stick_count ||
+        creature.muscles != muscles) {
+        throw std::invalid_argument("Creature has a different morphology than the batch");
+    }
+    if (creature.terrain != terrain) {
+        throw std::invalid_argument("Creature has a different terrain than the batch");
+    }
+
+    for (int p = 0; p < point_count; p++) {
+        const auto &point = creature.points[p];
+        const std::size_t i = (std::size_t) p * count + lane;
+        x[i] = point.position.x;
+        y[i] = point.position.y;
+        old_x[i] = point.old_position.x;
+        old_y[i] = point.old_position.y;
+        force_x[i] = point.force.x;
+        force_y[i] = point.force.y;
+        pressure[i] = point.pressure;
+    }
+    for (int s = 0; s < stick_count; s++) {
+        desired_length[(std::size_t) s * count + lane] = creature.sticks[s].desired_length;
+    }
+    for (std::size_t m = 0; m < muscles.size(); m++) {
+        rest_lengths[m * count + lane] = creature.rest_lengths[m];
+    }
+    controllers[lane] = creature.controller;
+    network_values[lane].resize(creature.controller != nullptr ? creature.controller->node_count : 0);
+    time_until_decision[lane] = creature.time_until_decision;
+    highest_jump[lane] = creature.highest_jump;
+    energy_spent[lane] = creature.energy_spent;
+}
+
+template<typename Scalar>
+void BasicCreatureBatch<Scalar>::store(int lane, BasicCreature<Scalar> &creature) const {
+    if ((int) creature.points.size() != point_count || (int) creature.sticks.size() != stick_count) {
+        throw std::invalid_argument("Creature has a different morphology than the batch");
+    }
+
+    for (int p = 0; p < point_count; p++) {
+        auto &point = creature.points[p];
+        const std::size_t i = (std::size_t) p * count + lane;
+        point.position = {x[i], y[i]};
+        point.old_position = {old_x[i], old_y[i]};
+        point.force = {force_x[i], force_y[i]};
+        point.pressure = pressure[i];
+    }
+    for (int s = 0; s < stick_count; s++) {
+        creature.sticks[s].desired_length = desired_length[(std::size_t) s * count + lane];
+    }
+    creature.time_until_decision = time_until_decision[lane];
+    creature.highest_jump = highest_jump[lane];
+    creature.energy_spent = energy_spent[lane];
+    creature.steps = steps;
+}
+
+template<typename Scalar>
+void BasicCreatureBatch<Scalar>::timestep(Scalar delta) {
+    for (int lane = 0; lane < count; lane++) {
+        const FastNetwork *controller = controllers[lane];
+        if (controller != nullptr && controller->input_count > 0 && (time_until_decision[lane] -= delta) <= 0) {
+            time_until_decision[lane] = decision_period;
+            take_action(lane, delta);
+        }
+    }
+
+    move_points(delta);
+    constrain_points(delta);
+
+    // Lowest point of each lane, points are rows of lanes
+    for (int lane = 0; lane < count; lane++) {
+        Scalar jump_height = y[lane];
+        for (int p = 1; p < point_count; p++) {
+            Scalar height = y[(std::size_t) p * count + lane];
+            if (height < jump_height) jump_height = height;
+        }
+        if (jump_height > highest_jump[lane]) highest_jump[lane] = jump_height;
+    }
+
+    steps++;
+}
+
+template<typename Scalar>
+void BasicCreatureBatch<Scalar>::take_action(int lane, Scalar delta) {
+    // Same sensors in the same order as Creature::sense
+    double *inputs = sensor_values.data();
+    for (int p = 0; p < point_count; p++) {
+        *inputs++ = pressure[(std::size_t) p * count + lane];
+    }
+    for (int p = 0; p < point_count; p++) {
+        const std::size_t i = (std::size_t) p * count + lane;
+        *inputs++ = (x[i] - old_x[i]) / delta;
+        *inputs++ = (y[i] - old_y[i]) / delta;
+    }
+    for (int s = 0; s < stick_count; s++) {
+        const std::size_t first = (std::size_t) stick_ends[2 * s] * count + lane;
+        const std::size_t second = (std::size_t) stick_ends[2 * s + 1] * count + lane;
+        BasicVector2D<Scalar> direction(x[second] - x[first], y[second] - y[first]);
+        Scalar length = direction.length();
+        *inputs++ = direction.x / length;
+        *inputs++ = direction.y / length;
+    }
+    *inputs = 1;
+
+    const double *outputs = controllers[lane]->calculate(sensor_values.data(), network_values[lane].data());
+    for (std::size_t m = 0; m < muscles.size(); m++) {
+        Scalar &desired = desired_length[(std::size_t) muscles[m] * count + lane];
+        Scalar length = rest_lengths[m * count + lane] * (1 + muscle_strength * (Scalar) (2 * outputs[m] - 1));
+        energy_spent[lane] += std::abs(length - desired);
+        desired = length;
+    }
+}
+
+template<typename Scalar>
+void BasicCreatureBatch<Scalar>::move_points(Scalar delta) {
+    const int size = point_count * count;
+    Scalar *px = x.data();
+    Scalar *py = y.data();
+    Scalar *pox = old_x.data();
+    Scalar *poy = old_y.data();
+    Scalar *pfx = force_x.data();
+    Scalar *pfy = force_y.data();
+    const Scalar *pp = pressure.data();
+
+    // Arrays never overlap, too many of them for the compiler to check at runtime
+#pragma GCC ivdep
+    for (int i = 0; i < size; i++) {
+        Scalar vx = (px[i] - pox[i]) / delta;
+        Scalar vy = (py[i] - poy[i]) / delta;
+        Scalar fx = pfx[i] + 0;
+        Scalar fy = pfy[i] + Scalar(-0.9);
+
+        // Friction against the direction of movement, branchless so the loop vectorises
+        Scalar friction = pp[i] / 10;
+        fx = vx > 0 ? fx - friction : (vx < 0 ? fx + friction : fx);
+
+        pox[i] = px[i];
+        poy[i] = py[i];
+        px[i] += (vx + fx) * delta;
+        py[i] += (vy + fy) * delta;
+        pfx[i] = fx * 0;
+        pfy[i] = fy * 0;
+    }
+}
+
+template<typename Scalar>
+void BasicCreatureBatch<Scalar>::constrain_points(Scalar delta) {
+    int iterations = 0;
+    if (constraint_tolerance > 0) {
+        while (iterations < max_constraint_iterations) {
+            std::fill(lane_error.begin(), lane_error.end(), 0);
+            solve_sticks<true>();
+            iterations++;
+            // lane_error holds halves of relative errors (see Stick::constrain_points)
+            if (2 * *std::max_element(lane_error.begin(), lane_error.end()) < constraint_tolerance) break;
+        }
+    } else {
+        for (; iterations < constraint_iterations; iterations++) {
+            solve_sticks<false>();
+        }
+    }
+
+    if ((int) iteration_histogram.size() <= iterations) iteration_histogram.resize(iterations + 1);
+    iteration_histogram[iterations]++;
+
+    const int size = point_count * count;
+    Scalar *py = y.data();
+    Scalar *pp = pressure.data();
+    if (terrain == nullptr) {
+        for (int i = 0; i < size; i++) {
+            bool below = py[i] < 0;
+            pp[i] = below ? -py[i] / delta : 0;
+            py[i] = below ? 0 : py[i];
+        }
+        return;
+    }
+
+    // Ground of all points at once, then contacts in a loop like the flat one
+    const Scalar *pg = ground.data();
+    terrain->height(x.data(), ground.data(), size);
+    for (int i = 0; i < size; i++) {
+        bool below = py[i] < pg[i];
+        pp[i] = below ? (pg[i] - py[i]) / delta : 0;
+        py[i] = below ? pg[i] : py[i];
+    }
+}
+
+template<typename Scalar>
+template<bool measure>
+void BasicCreatureBatch<Scalar>::solve_sticks() {
+    const int colour_count = (int) colour_offsets.size() - 1;
+    // Sticks of a colour are independent, only colours have to be solved in order
+    for (int colour = 0; colour < colour_count; colour++) {
+        for (int s = colour_offsets[colour]; s < colour_offsets[colour + 1]; s++) {
+            if (fast_inverse_sqrt) {
+                constrain_stick<true, measure>(s);
+            } else {
+                constrain_stick<false, measure>(s);
+            }
+        }
+    }
+}
+
+template<typename Scalar>
+template<bool fast, bool measure>
+void BasicCreatureBatch<Scalar>::constrain_stick(int stick) {
+    const std::size_t first = (std::size_t) stick_ends[2 * stick] * count;
+    const std::size_t second = (std::size_t) stick_ends[2 * stick + 1] * count;
+    Scalar *x0 = x.data() + first;
+    Scalar *y0 = y.data() + first;
+    Scalar *x1 = x.data() + second;
+    Scalar *y1 = y.data() + second;
+    const Scalar *length = desired_length.data() + (std::size_t) stick * count;
+    Scalar *error = lane_error.data();
+
+    for (int lane = 0; lane < count; lane++) {
+        Scalar dx = x1[lane] - x0[lane];
+        Scalar dy = y1[lane] - y0[lane];
+        Scalar correction;
+        if constexpr (fast) {
+            correction = (1 - length[lane] * BasicStick<Scalar>::inverse_sqrt(dx * dx + dy * dy)) / 2;
+        } else {
+            Scalar d = std::sqrt(dx * dx + dy * dy);
+            correction = (d - length[lane]) / d / 2;
+        }
+
+        x0[lane] += dx * correction;
+        y0[lane] += dy * correction;
+        x1[lane] += dx * -correction;
+        y1[lane] += dy * -correction;
+        if constexpr (measure) {
+            error[lane] = std::max(error[lane], std::abs(correction));
+        }
+    }
+}
+
+template<typename Scalar>
+Scalar BasicCreatureBatch<Scalar>::distance_ran(int lane) const {
+    Scalar distance = x[lane];
+    for (int p = 1; p < point_count; p++) {
+        distance = std::max(distance, x[(std::size_t) p * count + lane]);
+    }
+    return distance;
+}
+
+template<typename Scalar>
+BasicVector2D<Scalar> BasicCreatureBatch<Scalar>::centre(int lane) const {
+    BasicVector2D<Scalar> sum;
+    for (int p = 0; p < point_count; p++) {
+        const std::size_t i = (std::size_t) p * count + lane;
+        sum += BasicVector2D<Scalar>(x[i], y[i]);
+    }
+    return sum / (Scalar) point_count;
+}
+
+template<typename Scalar>
+Scalar BasicCreatureBatch<Scalar>::extent(int lane) const {
+    Scalar extent = 0;
+    for (int p = 0; p < point_count; p++) {
+        const std::size_t i = (std::size_t) p * count + lane;
+        if (!std::isfinite(x[i]) || !std::isfinite(y[i])) {
+            return std::numeric_limits<Scalar>::infinity();
+        }
+        extent = std::max({extent, std::abs(x[i]), std::abs(y[i])});
+    }
+    return extent;
+}
+
+template class BasicCreatureBatch<float>;
+template class BasicCreatureBatch<double>;
@@ -0,0 +1,215 @@
+#ifndef NEAT_CREATUREBATCH_H
+#define NEAT_CREATUREBATCH_H
+
+#include <vector>
+
+#include "Creature.h"
+#include "Terrain.h"
+#include "Vector2D.h"
+#include "../utils/FastNetwork.h"
+
+/**
+ * Physics of many creatures with the same morphology, stored as structure of arrays, on a given scalar type.
+ * Float batches fit twice as many lanes in a vector register as double ones.
+ *
+ * Every point state (position, old position, force, pressure) is an array of count lanes per point, index
+ * point * count + lane, so each step of the simulation is a loop over lanes the compiler vectorises.
+ * Sticks are solved colour by colour in the order of Creature::sticks, each for all lanes at once.
+ *
+ * Operations are done in the same order as in Creature::timestep, so with multiply-add contraction disabled
+ * (see CMakeLists.txt) lanes give the same results as separately simulated creatures, bit for bit.
+ * Each lane has its own controller. Decisions are taken lane by lane, as networks differ in topology,
+ * with buffers allocated when a creature is loaded. Points don't collide (see Creature::collide).
+ */
+template<typename Scalar>
+class BasicCreatureBatch {
+private:
+    /**
+     * Largest correction of each lane in the current sweep, used with constraint_tolerance.
+     */
+    std::vector<Scalar> lane_error;
+
+    /**
+     * Solve a stick in all lanes.
+     * @tparam fast use Stick::inverse_sqrt
+     * @tparam measure update lane_error
+     * @param stick index of the stick
+     */
+    template<bool fast, bool measure>
+    void constrain_stick(int stick);
+
+    /**
+     * Solve every stick once in all lanes.
+     * @tparam measure update lane_error
+     */
+    template<bool measure>
+    void solve_sticks();
+
+    /**
+     * Network inputs of the deciding lane. (see Creature::sense)
+     */
+    std::vector<double> sensor_values;
+
+    /**
+     * Node values of the controller of each lane.
+     */
+    std::vector<std::vector<double>> network_values;
+
+    /**
+     * Height of the ground under every point, same layout as y.
+     */
+    std::vector<Scalar> ground;
+
+public:
+    const int count;
+    const int point_count;
+    const int stick_count;
+
+    std::vector<Scalar> x;
+    std::vector<Scalar> y;
+    std::vector<Scalar> old_x;
+    std::vector<Scalar> old_y;
+    std::vector<Scalar> force_x;
+    std::vector<Scalar> force_y;
+    std::vector<Scalar> pressure;
+
+    /**
+     * Indices of points connected by each stick, two per stick, in the order of Creature::sticks.
+     */
+    std::vector<int> stick_ends;
+
+    /**
+     * Index of the first stick of each colour, followed by stick_count. (see Creature::colour_offsets)
+     */
+    std::vector<int> colour_offsets;
+
+    /**
+     * Ground under all lanes, flat at height 0 if nullptr. (see Creature::terrain)
+     */
+    const Terrain *terrain;
+
+    /**
+     * Desired length of each stick in each lane, index stick * count + lane. Lengths are measured on the
+     * creature loaded into a lane, so they can differ by rounding between poses.
+     */
+    std::vector<Scalar> desired_length;
+
+    /**
+     * Network controlling each lane, nullptr if the lane is not controlled. Networks must outlive the batch.
+     */
+    std::vector<const FastNetwork *> controllers;
+
+    /**
+     * Indices of muscle sticks, in the order of network outputs. (see Creature::muscles)
+     */
+    std::vector<int> muscles;
+
+    /**
+     * Rest length of each muscle in each lane, index muscle * count + lane.
+     */
+    std::vector<Scalar> rest_lengths;
+    Scalar muscle_strength;
+    Scalar decision_period;
+    std::vector<Scalar> time_until_decision;
+
+    /**
+     * Number of times stick constraints are solved every timestep, when constraint_tolerance is 0.
+     */
+    int constraint_iterations = 5;
+
+    /**
+     * Largest relative stick length error accepted after a timestep, in every lane.
+     * (see Creature::constraint_tolerance) All lanes are solved the same number of times, so lanes match
+     * separately simulated creatures only when it is 0.
+     */
+    Scalar constraint_tolerance = 0;
+    int max_constraint_iterations = 20;
+
+    /**
+     * Number of timesteps that solved sticks a given number of times, indexed by that number.
+     */
+    std::vector<long> iteration_histogram;
+
+    /**
+     * Solve sticks with an approximate inverse square root. (see Stick::inverse_sqrt)
+     */
+    bool fast_inverse_sqrt = false;
+
+    std::vector<Scalar> highest_jump;
+    std::vector<Scalar> energy_spent;
+
+    /**
+     * Number of timesteps simulated so far.
+     */
+    int steps = 0;
+
+    /**
+     * Create a batch with every lane in the state of a creature.
+     * @param creature creature giving the morphology and the initial state
+     * @param count number of lanes
+     */
+    BasicCreatureBatch(const BasicCreature<Scalar> &creature, int count);
+
+    /**
+     * Copy state and controller of a creature into a lane. The creature must have the morphology, muscles and
+     * terrain of the batch.
+     * @param lane
+     * @param creature
+     */
+    void load(int lane, const BasicCreature<Scalar> &creature);
+
+    /**
+     * Copy state of a lane into a creature. The creature must have the morphology of the batch.
+     * @param lane
+     * @param creature
+     */
+    void store(int lane, BasicCreature<Scalar> &creature) const;
+
+    /**
+     * Advance every lane by a timestep. (see Creature::timestep)
+     * @param delta
+     */
+    void timestep(Scalar delta);
+
+    /**
+     * Read sensors of a lane, run its controller and set its muscle lengths. (see Creature::take_action)
+     * @param lane
+     * @param delta
+     */
+    void take_action(int lane, Scalar delta);
+
+    /**
+     * Integrate point movement (see Point::timestep).
+     * @param delta
+     */
+    void move_points(Scalar delta);
+
+    /**
+     * Solve stick constraints, then push points out of the ground. (see Creature::constrain_points)
+     * @param delta
+     */
+    void constrain_points(Scalar delta);
+
+    [[nodiscard]] Scalar distance_ran(int lane) const;
+
+    /**
+     * Calculate average position of points of a lane.
+     * @param lane
+     * @return centre of the creature
+     */
+    [[nodiscard]] BasicVector2D<Scalar> centre(int lane) const;
+
+    /**
+     * Calculate the largest absolute coordinate of a point of a lane. (see Creature::extent)
+     * @param lane
+     * @return largest absolute coordinate, infinity if any coordinate is not finite
+     */
+    [[nodiscard]] Scalar extent(int lane) const;
+};
+
+extern template class BasicCreatureBatch<float>;
+extern template class BasicCreatureBatch<double>;
+
+using CreatureBatch = BasicCreatureBatch<double>;
+
+#endif
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "CreatureFile.h"
+
+Scenario CreatureFile::parse(const std::string &text) {
+    Scenario scenario;
+    std::istringstream lines(text);
+    std::string line;
+    for (int number = 1; std::getline(lines, line); number++) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        std::string kind;
+        if (!(words >> kind)) continue;
+
+        bool valid;
+        if (kind == "point") {
+            double x, y;
+            valid = (bool) (words >> x >> y);
+            if (valid) scenario.points.emplace_back(x, y);
+        } else if (kind == "stick" || kind == "muscle") {
+            int first, second;
+            const int point_count = (int) scenario.points.size();
+            valid = words >> first >> second && first != second && first >= 0 && first < point_count &&
+                    second >= 0 && second < point_count;
+            if (valid && kind == "muscle") scenario.muscles.push_back((int) scenario.connections.size());
+            if (valid) scenario.connections.emplace_back(first, second);
+        } else {
+            valid = false;
+        }
+
+        std::string rest;
+        if (!valid || words >> rest) {
+            throw std::runtime_error("Malformed creature at line " + std::to_string(number) + ": " + line);
+        }
+    }
+
+    if (scenario.points.empty()) {
+        throw std::runtime_error("Creature has no points");
+    }
+    return scenario;
+}
+
+Scenario CreatureFile::load(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Can't open creature " + path);
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return parse(text.str());
+}
+
+void CreatureFile::save(const Scenario &scenario, const std::string &path) {
+    std::ofstream file(path);
+    file.precision(17);
+    for (const auto &point: scenario.points) {
+        file << "point " << point.x << ' ' << point.y << '\n';
+    }
+    for (int i = 0; i < (int) scenario.connections.size(); i++) {
+        bool muscle = std::find(scenario.muscles.begin(), scenario.muscles.end(), i) != scenario.muscles.end();
+        const auto &[first, second] = scenario.connections[i];
+        file << (muscle ? "muscle " : "stick ") << first << ' ' << second << '\n';
+    }
+    if (!file.flush()) {
+        throw std::runtime_error("Can't write creature " + path);
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef NEAT_CREATUREFILE_H
+#define NEAT_CREATUREFILE_H
+
+#include <string>
+
+#include "ScenarioSet.h"
+
+/**
+ * Reads and writes creature definitions as text, one item per line:
+ *
+ *     # comment
+ *     point <x> <y>
+ *     stick <first point> <second point>
+ *     muscle <first point> <second point>
+ *
+ * Points are numbered from 0 in the order they appear, a stick may only connect points defined before it.
+ * A muscle is a stick whose length is controlled by the network. If there are no muscles, all sticks are.
+ */
+class CreatureFile {
+public:
+    /**
+     * Parse a creature definition. Throws std::runtime_error naming the line if it is malformed.
+     * @param text content of a creature file
+     * @return scenario with the creature in its default pose
+     */
+    static Scenario parse(const std::string &text);
+
+    /**
+     * Read a creature definition from a file. Throws std::runtime_error if it can't be read or is malformed.
+     * @param path path to the file
+     * @return scenario with the creature in its default pose
+     */
+    static Scenario load(const std::string &path);
+
+    /**
+     * Write points, sticks and muscles of a scenario to a file. Throws std::runtime_error if it can't be written.
+     * @param scenario creature to write (pose is not saved)
+     * @param path path to the file
+     */
+    static void save(const Scenario &scenario, const std::string &path);
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef NEAT_CREATURETEMPLATE_H
+#define NEAT_CREATURETEMPLATE_H
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Creature.h"
+#include "../utils/FastNetwork.h"
+
+/**
+ * Initial state of a creature, built once so that creatures don't have to be built from points and connections
+ * for every evaluation (normalising the position, measuring sticks and colouring them).
+ *
+ * Creatures are either copied from the template, or pooled and reset to it: point states are copied with
+ * a single memcpy and stick lengths restored in place, without any allocation.
+ */
+template<typename Scalar>
+class BasicCreatureTemplate {
+public:
+    /**
+     * Creature in its initial state, without a controller. It is never simulated.
+     */
+    const BasicCreature<Scalar> initial;
+
+    /**
+     * Create a template of a creature in its current state.
+     * @param creature
+     */
+    explicit BasicCreatureTemplate(const BasicCreature<Scalar> &creature) : initial(creature) {}
+
+    /**
+     * Create a new creature in the initial state.
+     * @param network network controlling the creature, must outlive it, nullptr for none
+     * @return new creature
+     */
+    [[nodiscard]] std::unique_ptr<BasicCreature<Scalar>> instantiate(const FastNetwork *network) const {
+        auto creature = std::make_unique<BasicCreature<Scalar>>(initial);
+        creature->attach(network);
+        return creature;
+    }
+
+    /**
+     * Put a creature created by instantiate back into the initial state, keeping its controller.
+     * Settings (decision period, constraint solving, trajectory sampling, collisions, recording) are restored too.
+     * Throws std::invalid_argument if the creature has a different morphology.
+     * @param creature
+     */
+    void reset(BasicCreature<Scalar> &creature) const {
+        static_assert(std::is_trivially_copyable_v<BasicPoint<Scalar>>, "Points are copied with memcpy");
+        if (creature.points.size() != initial.points.size() || creature.sticks.size() != initial.sticks.size()) {
+            throw std::invalid_argument("Creature has a different morphology than the template");
+        }
+
+        std::memcpy(creature.points.data(), initial.points.data(), initial.points.size() * sizeof(initial.points[0]));
+        // Sticks point at points of their own creature, only their lengths change
+        for (std::size_t s = 0; s < initial.sticks.size(); s++) {
+            creature.sticks[s].desired_length = initial.sticks[s].desired_length;
+        }
+
+        creature.muscle_strength = initial.muscle_strength;
+        creature.decision_period = initial.decision_period;
+        creature.constraint_iterations = initial.constraint_iterations;
+        creature.constraint_tolerance = initial.constraint_tolerance;
+        creature.max_constraint_iterations = initial.max_constraint_iterations;
+        creature.fast_inverse_sqrt = initial.fast_inverse_sqrt;
+        creature.trajectory_period = initial.trajectory_period;
+        creature.collision_radius = initial.collision_radius;
+        creature.recorder = initial.recorder;
+
+        creature.time_until_decision = initial.time_until_decision;
+        creature.energy_spent = initial.energy_spent;
+        creature.highest_jump = initial.highest_jump;
+        creature.steps = initial.steps;
+        creature.contacts = initial.contacts;
+        // Clearing keeps the capacity for the next episode
+        creature.iteration_histogram.clear();
+        creature.trajectory.clear();
+        // Collision order depends on the order of items in hashes, rebuilding them makes episodes reproducible
+        creature.point_cell = 0;
+        creature.stick_cell = 0;
+    }
+};
+
+using CreatureTemplate = BasicCreatureTemplate<double>;
+
+#endif
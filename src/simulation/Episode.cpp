@@ -0,0 +1,66 @@
+#include <cmath>
+
+#include "Episode.h"
+
+Episode::Episode(EpisodeController &controller, double cutoff, int max_steps)
+        : controller(controller), cutoff(cutoff), max_steps(max_steps) {}
+
+bool Episode::stop(StopReason stop_reason) {
+    finished = true;
+    reason = stop_reason;
+    controller.stops[(int) stop_reason]++;
+    controller.steps_run += step;
+    controller.steps_saved += max_steps - step;
+    return false;
+}
+
+bool Episode::report(double progress, double magnitude) {
+    if (finished) return false;
+    step++;
+
+    // Also catches NaN
+    if (!(magnitude <= controller.explosion_limit) || std::isnan(progress)) {
+        return stop(StopReason::Exploded);
+    }
+
+    if (progress > best_progress) best_progress = progress;
+    if (best_progress >= stall_progress + controller.stall_progress) {
+        stall_progress = best_progress;
+        stall_step = step;
+    }
+
+    if (step >= max_steps) {
+        return stop(StopReason::Completed);
+    }
+
+    if (controller.stall_steps > 0 && step - stall_step >= controller.stall_steps) {
+        return stop(StopReason::Stalled);
+    }
+
+    double bound = best_progress + controller.max_progress_rate * (max_steps - step);
+    if (bound < cutoff) {
+        return stop(StopReason::CannotBeatCutoff);
+    }
+
+    return true;
+}
+
+bool Episode::report(const Creature &creature) {
+    return report(creature.distance_ran(), creature.extent());
+}
+
+Episode EpisodeController::start(double cutoff, int steps) {
+    return {*this, cutoff, steps > 0 ? steps : max_steps};
+}
+
+long EpisodeController::count(StopReason reason) const {
+    return stops[(int) reason];
+}
+
+void EpisodeController::reset_counters() {
+    for (auto &s: stops) {
+        s = 0;
+    }
+    steps_run = 0;
+    steps_saved = 0;
+}
@@ -0,0 +1,133 @@
+#ifndef NEAT_EPISODE_H
+#define NEAT_EPISODE_H
+
+#include <atomic>
+#include <limits>
+
+#include "Creature.h"
+
+/**
+ * Reason an episode ended.
+ */
+enum class StopReason {
+    Completed,        /// all steps were simulated
+    Stalled,          /// progress didn't improve for stall_steps
+    CannotBeatCutoff, /// progress can't reach the cutoff in the remaining steps
+    Exploded          /// simulation became non-finite or too large
+};
+
+constexpr int stop_reason_count = 4;
+
+class EpisodeController;
+
+/**
+ * A single evaluation episode. The evaluator reports progress after every step and stops when told to.
+ * Progress is the value fitness is based on and must be on the same scale as the cutoff.
+ */
+class Episode {
+private:
+    EpisodeController &controller;
+    double cutoff;
+    int max_steps;
+
+    double best_progress = -std::numeric_limits<double>::infinity();
+
+    /**
+     * Best progress at the last improvement by at least stall_progress.
+     */
+    double stall_progress = -std::numeric_limits<double>::infinity();
+    int stall_step = 0;
+
+    /**
+     * Record the end of the episode.
+     * @param stop_reason reason the episode ended
+     * @return false
+     */
+    bool stop(StopReason stop_reason);
+
+public:
+    int step = 0;
+    bool finished = false;
+    StopReason reason = StopReason::Completed;
+
+    /**
+     * Start an episode.
+     * @param controller controller with stopping rules and counters
+     * @param cutoff progress the episode has to be able to reach to continue
+     * @param max_steps number of steps of a complete episode
+     */
+    Episode(EpisodeController &controller, double cutoff, int max_steps);
+
+    /**
+     * Report progress after a step.
+     * @param progress current progress (for example distance ran)
+     * @param magnitude largest absolute value in the simulation state
+     * @return true if the episode should continue
+     */
+    bool report(double progress, double magnitude);
+
+    /**
+     * Report progress of a creature after a timestep. Progress is distance ran.
+     * @param creature simulated creature
+     * @return true if the episode should continue
+     */
+    bool report(const Creature &creature);
+};
+
+/**
+ * Rules for stopping evaluation episodes early and counters of why episodes ended.
+ * Shared by all evaluations, counters can be updated from multiple threads.
+ */
+class EpisodeController {
+public:
+    int max_steps = 500;
+
+    /**
+     * Stop if progress doesn't improve by stall_progress in stall_steps steps. (0 disables the rule)
+     */
+    int stall_steps = 100;
+    double stall_progress = 0.01;
+
+    /**
+     * Largest increase of progress in a step, used to bound final progress. Infinity disables stopping episodes
+     * that can't beat the cutoff. The default (10 per second at delta 0.01) suits distance: evolved creatures
+     * average at most about 6.5 per second over an episode, single steps can be much faster but only briefly.
+     */
+    double max_progress_rate = 0.1;
+
+    /**
+     * Stop if any value of the simulation state exceeds the limit.
+     */
+    double explosion_limit = 1e6;
+
+    /**
+     * Number of episodes that ended for each reason.
+     */
+    std::atomic<long> stops[stop_reason_count] = {};
+
+    std::atomic<long> steps_run = 0;
+
+    /**
+     * Steps that weren't simulated because of early stopping.
+     */
+    std::atomic<long> steps_saved = 0;
+
+    /**
+     * Start an episode.
+     * @param cutoff progress the episode has to be able to reach (for example species survival cutoff)
+     * @param steps number of steps of a complete episode, max_steps if 0
+     * @return new episode
+     */
+    Episode start(double cutoff = -std::numeric_limits<double>::infinity(), int steps = 0);
+
+    /**
+     * Get the number of episodes that ended for a reason.
+     * @param reason
+     * @return number of episodes
+     */
+    [[nodiscard]] long count(StopReason reason) const;
+
+    void reset_counters();
+};
+
+#endif
@@ -6,18 +6,33 @@
 /**
  * Class containing joint information.
  */
-class Point {
+template<typename Scalar>
+class BasicPoint {
 public:
-    Vector2D position;
-    Vector2D old_position;
-    Vector2D force;
+    using Vector = BasicVector2D<Scalar>;
 
-    double pressure = 0;
+    Vector position;
+    Vector old_position;
+    Vector force;
 
-    explicit Point(const Vector2D& position);
+    Scalar pressure = 0;
 
-    void timestep(double delta);
+    explicit BasicPoint(const Vector &position) : position(position), old_position(position) {}
+
+    void timestep(Scalar delta) {
+        Vector velocity = (position - old_position) / delta;
+        force += Vector(0, Scalar(-0.9));
+        if (velocity.x > 0) {
+            force.x -= pressure / 10;
+        } else if (velocity.x < 0) {
+            force.x += pressure / 10;
+        }
+        old_position = position;
+        position += (velocity + force) * delta;
+        force *= 0;
+    }
 };
 
+using Point = BasicPoint<double>;
 
 #endif //NEAT_POINT_H
@@ -0,0 +1,232 @@
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#include "Recording.h"
+#include "../utils/Bytes.h"
+
+static const char file_magic[8] = {'N', 'E', 'A', 'T', 'R', 'E', 'C', 'D'};
+static const char chunk_magic[4] = {'C', 'H', 'N', 'K'};
+
+Recording::Writer::Writer(const std::string &path, int point_count, const std::vector<std::pair<int, int>> &sticks,
+                          double delta, const Terrain *terrain, double quantum, int chunk_frames)
+        : chunk_frames(chunk_frames), inverse_quantum(1 / quantum), previous(2 * point_count),
+          current(2 * point_count) {
+    if (point_count <= 0 || chunk_frames <= 0 || !(quantum > 0)) {
+        throw std::invalid_argument("Recording needs points, positive quantum and chunk frames");
+    }
+
+    // A new file rather than truncating the old one, which readers may have mapped
+    std::error_code error;
+    if (std::filesystem::is_regular_file(path, error)) {
+        std::filesystem::remove(path, error);
+    }
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, file_magic, sizeof(file_magic));
+    header.version = version;
+    header.point_count = point_count;
+    header.stick_count = sticks.size();
+    header.chunk_frames = chunk_frames;
+    header.delta = delta;
+    header.quantum = quantum;
+    if (terrain != nullptr) {
+        header.terrain_start = terrain->start;
+        header.terrain_spacing = terrain->spacing;
+        header.terrain_count = terrain->heights.size();
+    }
+
+    std::vector<std::uint8_t> start;
+    ByteWriter start_writer(start);
+    start_writer.write_bytes(&header, sizeof(header));
+    for (auto [a, b]: sticks) {
+        std::uint32_t ends[2] = {(std::uint32_t) a, (std::uint32_t) b};
+        start_writer.write_bytes(ends, sizeof(ends));
+    }
+    if (terrain != nullptr) {
+        start_writer.write_bytes(terrain->heights.data(), terrain->heights.size() * sizeof(double));
+    }
+    start.resize((start.size() + 7) / 8 * 8);
+    std::fwrite(start.data(), 1, start.size(), file);
+    std::fflush(file);
+    written = start.size();
+
+    // Header, keyframe, up to 5 bytes per coordinate of every other frame and padding
+    chunk.resize(sizeof(ChunkHeader) + previous.size() * (sizeof(std::int32_t) + 5 * (chunk_frames - 1)) + 8);
+
+    thread = std::thread(&Writer::write, this);
+}
+
+Recording::Writer::~Writer() {
+    finish_chunk();
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+
+    std::fclose(file);
+}
+
+void Recording::Writer::finish_chunk() {
+    if (chunk_frame_count == 0) return;
+
+    std::size_t padded_size = (payload_size + 7) / 8 * 8;
+    std::uint8_t *payload = chunk.data() + sizeof(ChunkHeader);
+    std::memset(payload + payload_size, 0, padded_size - payload_size);
+
+    ChunkHeader header{};
+    std::memcpy(header.magic, chunk_magic, sizeof(chunk_magic));
+    header.frame_count = chunk_frame_count;
+    header.first_frame = frames - chunk_frame_count;
+    header.payload_size = padded_size;
+    std::memcpy(chunk.data(), &header, sizeof(header));
+    written += sizeof(header) + padded_size;
+
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [this] { return queue.size() < max_queued; });
+    // Buffer keeps its size, the used part is known from the header
+    queue.push_back(std::move(chunk));
+    if (spare.empty()) {
+        chunk.resize(queue.back().size());
+    } else {
+        chunk = std::move(spare.back());
+        spare.pop_back();
+    }
+    changed.notify_all();
+
+    payload_size = 0;
+    chunk_frame_count = 0;
+}
+
+void Recording::Writer::write() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) return;
+
+        // Only this thread removes chunks, so the front stays valid while unlocked
+        const auto &buffer = queue.front();
+        lock.unlock();
+
+        // Readers ignore the chunk until its whole payload is in the file
+        const auto *header = (const ChunkHeader *) buffer.data();
+        std::fwrite(buffer.data(), 1, sizeof(ChunkHeader) + header->payload_size, file);
+        std::fflush(file);
+
+        lock.lock();
+        spare.push_back(std::move(queue.front()));
+        queue.pop_front();
+        changed.notify_all();
+    }
+}
+
+Recording::Reader::Reader(const std::string &path) : data(path) {
+    header = (const FileHeader *) data.data();
+    if (data.size() < sizeof(FileHeader) || std::memcmp(header->magic, file_magic, sizeof(file_magic)) != 0) {
+        throw std::runtime_error("Not a recording: " + path);
+    }
+    if (header->version != version) {
+        throw std::runtime_error("Unsupported recording version: " + path);
+    }
+
+    std::size_t offset = sizeof(FileHeader);
+    std::size_t tables = header->stick_count * 2 * sizeof(std::uint32_t) + header->terrain_count * sizeof(double);
+    if (header->point_count == 0 || header->chunk_frames == 0 || tables > data.size() - offset) {
+        throw std::runtime_error("Malformed recording: " + path);
+    }
+
+    const auto *ends = (const std::uint32_t *) (data.data() + offset);
+    for (std::uint32_t i = 0; i < header->stick_count; i++) {
+        if (ends[2 * i] >= header->point_count || ends[2 * i + 1] >= header->point_count) {
+            throw std::runtime_error("Malformed recording: " + path);
+        }
+        sticks.emplace_back(ends[2 * i], ends[2 * i + 1]);
+    }
+    offset += header->stick_count * 2 * sizeof(std::uint32_t);
+
+    if (header->terrain_count > 0) {
+        const auto *heights = (const double *) (data.data() + offset);
+        terrain = std::make_unique<Terrain>(header->terrain_start, header->terrain_spacing,
+                                            std::vector<double>(heights, heights + header->terrain_count));
+        offset += header->terrain_count * sizeof(double);
+    }
+    offset = (offset + 7) / 8 * 8;
+
+    // Ignore a chunk that was being written when the recording was opened
+    std::size_t keyframe_size = 2 * header->point_count * sizeof(std::int32_t);
+    while (offset + sizeof(ChunkHeader) <= data.size()) {
+        const auto *chunk = (const ChunkHeader *) (data.data() + offset);
+        if (chunk->payload_size > data.size() - offset - sizeof(ChunkHeader)) break;
+
+        if (std::memcmp(chunk->magic, chunk_magic, sizeof(chunk_magic)) != 0 ||
+            chunk->first_frame != (std::uint64_t) chunks.size() * header->chunk_frames ||
+            chunk->frame_count == 0 || chunk->frame_count > header->chunk_frames ||
+            chunk->payload_size < keyframe_size) {
+            throw std::runtime_error("Malformed recording: " + path);
+        }
+        chunks.push_back(offset);
+        offset += sizeof(ChunkHeader) + chunk->payload_size;
+
+        // Only the last chunk may be short
+        if (chunk->frame_count < header->chunk_frames) break;
+    }
+
+    cursor_values.resize(2 * header->point_count);
+}
+
+long Recording::Reader::frame_count() const {
+    if (chunks.empty()) return 0;
+    const auto *last = (const ChunkHeader *) (data.data() + chunks.back());
+    return (long) (last->first_frame + last->frame_count);
+}
+
+void Recording::Reader::frame(long frame, std::vector<Vector2D> &positions) const {
+    if (frame < 0 || frame >= frame_count()) {
+        throw std::out_of_range("Frame " + std::to_string(frame) + " is not recorded");
+    }
+
+    long chunk_frames = header->chunk_frames;
+    if (cursor_frame > frame || cursor_frame < frame - frame % chunk_frames) {
+        // Start from the keyframe of the chunk
+        const std::uint8_t *chunk = data.data() + chunks[frame / chunk_frames];
+        cursor_end = chunk + sizeof(ChunkHeader) + ((const ChunkHeader *) chunk)->payload_size;
+        cursor = chunk + sizeof(ChunkHeader);
+        std::memcpy(cursor_values.data(), cursor, cursor_values.size() * sizeof(std::int32_t));
+        cursor += cursor_values.size() * sizeof(std::int32_t);
+        cursor_frame = frame - frame % chunk_frames;
+    }
+
+    for (; cursor_frame < frame; cursor_frame++) {
+        for (auto &value: cursor_values) {
+            if (cursor_end - cursor < (long) sizeof(std::int8_t)) {
+                cursor_frame = -1;
+                throw std::runtime_error("Malformed recording chunk");
+            }
+            auto difference = (std::int8_t) *cursor++;
+            if (difference != escape) {
+                value = (std::int32_t) ((std::uint32_t) value + (std::uint32_t) difference);
+                continue;
+            }
+
+            if (cursor_end - cursor < (long) sizeof(value)) {
+                cursor_frame = -1;
+                throw std::runtime_error("Malformed recording chunk");
+            }
+            std::memcpy(&value, cursor, sizeof(value));
+            cursor += sizeof(value);
+        }
+    }
+
+    positions.resize(header->point_count);
+    for (std::uint32_t i = 0; i < header->point_count; i++) {
+        positions[i] = Vector2D(cursor_values[2 * i] * header->quantum, cursor_values[2 * i + 1] * header->quantum);
+    }
+}
@@ -0,0 +1,284 @@
+#ifndef NEAT_RECORDING_H
+#define NEAT_RECORDING_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Point.h"
+#include "Terrain.h"
+#include "Vector2D.h"
+#include "../utils/MappedFile.h"
+
+/**
+ * Streaming recording of point positions of a creature, one frame per timestep, replayed without simulating.
+ *
+ * The file starts with a FileHeader, the sticks (pairs of uint32 point indices) and the terrain heights (doubles),
+ * padded to 8 bytes. Then follow chunks of up to chunk_frames frames: a ChunkHeader and a payload with the first
+ * frame as int32 coordinates and every other frame as int8 differences from the frame before it (see escape).
+ * Coordinates are positions divided by quantum and rounded, with the default quantum a byte covers moves of up to
+ * 12.7 cm per timestep. Differences have a fixed size rather than being varints, as encoding varints of
+ * unpredictable lengths costs several times more. Chunks are padded to 8 bytes.
+ *
+ * Chunks are written as they fill up and only the last one may be short, so a recording can be replayed while
+ * it is written. A Reader seeks to a frame by decoding at most one chunk, from its first frame.
+ */
+class Recording {
+public:
+    static constexpr std::uint32_t version = 1;
+
+    /**
+     * Difference marking that the coordinate follows as an int32.
+     */
+    static constexpr std::int8_t escape = INT8_MIN;
+
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t point_count;
+        std::uint32_t stick_count;
+        std::uint32_t chunk_frames;  /// frames in every chunk except the last one
+        double delta;                /// timestep between frames
+        double quantum;              /// length of a coordinate unit
+        double terrain_start;
+        double terrain_spacing;
+        std::uint64_t terrain_count; /// number of terrain heights, 0 for flat ground
+    };
+
+    struct ChunkHeader {
+        char magic[4];
+        std::uint32_t frame_count;
+        std::uint64_t first_frame;
+        std::uint64_t payload_size;  /// size of the payload (including padding)
+    };
+
+    static_assert(sizeof(FileHeader) == 64);
+    static_assert(sizeof(ChunkHeader) == 24);
+
+    /**
+     * Writes frames to a recording. Frames are encoded into a chunk buffer allocated up front, and full chunks are
+     * written from a background thread, so recording a frame neither allocates nor waits for I/O.
+     */
+    class Writer {
+    private:
+        std::FILE *file;
+        std::uint64_t frames = 0;
+        std::uint64_t written = 0;
+        std::uint32_t chunk_frames;
+        double inverse_quantum;
+
+        /**
+         * Chunk being recorded: header followed by the payload. Has room for a full chunk of the largest frames,
+         * so recording doesn't check its size. (payload_size is the used part of the payload)
+         */
+        std::uint32_t chunk_frame_count = 0;
+        std::vector<std::uint8_t> chunk;
+        std::size_t payload_size = 0;
+
+        /**
+         * Chunks waiting to be written, and written chunks whose buffers are reused.
+         */
+        std::deque<std::vector<std::uint8_t>> queue;
+        std::vector<std::vector<std::uint8_t>> spare;
+        std::mutex mutex;
+        std::condition_variable changed;
+        bool stopping = false;
+        std::thread thread;
+
+        /**
+         * Largest number of queued chunks, recording waits if the disk falls further behind.
+         */
+        static constexpr std::size_t max_queued = 64;
+
+        /**
+         * Coordinates of the last and of the current frame, x and y of every point.
+         */
+        std::vector<std::int32_t> previous;
+        std::vector<std::int32_t> current;
+
+        /**
+         * Queue the current chunk for writing, if it has any frames.
+         */
+        void finish_chunk();
+
+        /**
+         * Loop writing queued chunks.
+         */
+        void write();
+
+        /**
+         * Round a coordinate to quanta. Exact within 2^31 quanta, further away (or NaN of exploded creatures) the
+         * result is meaningless but defined, so differences are taken modulo 2^32.
+         */
+        [[nodiscard]] std::int32_t quantise(double coordinate) const {
+            // Adding 1.5 * 2^52 rounds to an integer in the low bits of the mantissa, without a conversion
+            double shifted = coordinate * inverse_quantum + 6755399441055744.0;
+            std::uint64_t bits;
+            std::memcpy(&bits, &shifted, sizeof(bits));
+            return (std::int32_t) (std::uint32_t) bits;
+        }
+
+        static std::int32_t difference(std::int32_t value, std::int32_t last) {
+            return (std::int32_t) ((std::uint32_t) value - (std::uint32_t) last);
+        }
+
+        /**
+         * Append the difference of coordinates as an int8, or the coordinate as an int32 after an escape if the
+         * difference doesn't fit.
+         * @return position after the written bytes, at most 5 further
+         */
+        static std::uint8_t *write_difference(std::uint8_t *out, std::int32_t value, std::int32_t last) {
+            std::int32_t change = difference(value, last);
+            if (change > escape && change <= INT8_MAX) {
+                auto small = (std::int8_t) change;
+                std::memcpy(out, &small, sizeof(small));
+                return out + sizeof(small);
+            }
+            std::memcpy(out, &escape, sizeof(escape));
+            std::memcpy(out + sizeof(escape), &value, sizeof(value));
+            return out + sizeof(escape) + sizeof(value);
+        }
+
+    public:
+        /**
+         * Create a recording, replacing an existing file (readers of it keep the old content).
+         * Throws std::system_error if it can't be opened.
+         * @param path path to the file
+         * @param point_count number of points of the creature
+         * @param sticks pairs of points connected with sticks, drawn by the viewer
+         * @param delta timestep between frames
+         * @param terrain ground of the creature, nullptr for flat ground
+         * @param quantum length of a coordinate unit
+         * @param chunk_frames frames per chunk, a Reader decodes at most this many frames to seek
+         */
+        Writer(const std::string &path, int point_count, const std::vector<std::pair<int, int>> &sticks, double delta,
+               const Terrain *terrain = nullptr, double quantum = 1e-3, int chunk_frames = 1024);
+
+        Writer(const Writer &) = delete;
+
+        Writer &operator=(const Writer &) = delete;
+
+        /**
+         * Write all chunks, including the last one, and close the recording.
+         */
+        ~Writer();
+
+        /**
+         * Record positions of points as the next frame.
+         * @tparam Scalar scalar type of the creature
+         * @param points points of the creature, as many as given when the recording was created
+         */
+        template<typename Scalar>
+        void record(const std::vector<BasicPoint<Scalar>> &points) {
+            std::int32_t *quantised = current.data();
+            for (const auto &point: points) {
+                *quantised++ = quantise((double) point.position.x);
+                *quantised++ = quantise((double) point.position.y);
+            }
+
+            std::uint8_t *payload = chunk.data() + sizeof(ChunkHeader);
+            std::uint8_t *out = payload + payload_size;
+            const int count = (int) current.size();
+            if (chunk_frame_count == 0) {
+                std::memcpy(out, current.data(), count * sizeof(std::int32_t));
+                out += count * sizeof(std::int32_t);
+            } else {
+                // Without branches, escapes are only written if a difference doesn't fit, over the differences.
+                // Bytes may alias anything, local pointers keep data pointers of the vectors in registers.
+                const std::int32_t *values = current.data();
+                const std::int32_t *last = previous.data();
+                std::int32_t lowest = 0, highest = 0;
+                for (int i = 0; i < count; i++) {
+                    std::int32_t change = difference(values[i], last[i]);
+                    out[i] = (std::uint8_t) change;
+                    lowest = std::min(lowest, change);
+                    highest = std::max(highest, change);
+                }
+                if (lowest > escape && highest <= INT8_MAX) {
+                    out += count;
+                } else {
+                    for (int i = 0; i < count; i++) {
+                        out = write_difference(out, values[i], last[i]);
+                    }
+                }
+            }
+            std::swap(current, previous);
+            payload_size = out - payload;
+
+            frames++;
+            if (++chunk_frame_count == chunk_frames) finish_chunk();
+        }
+
+        /**
+         * @return size of the recording in bytes, including frames not written yet
+         */
+        [[nodiscard]] std::uint64_t size() const {
+            return written + (chunk_frame_count > 0 ? sizeof(ChunkHeader) + payload_size : 0);
+        }
+    };
+
+    /**
+     * Reads a recording through a memory mapping. Sees chunks written before it was created.
+     */
+    class Reader {
+    private:
+        MappedFile data;
+
+        /**
+         * Offset of every complete chunk.
+         */
+        std::vector<std::size_t> chunks;
+
+        /**
+         * Decoded frame kept to continue from: index of the frame, read position after it, end of its chunk and
+         * its coordinates. Lets playing forward decode one frame at a time.
+         */
+        mutable long cursor_frame = -1;
+        mutable const std::uint8_t *cursor = nullptr;
+        mutable const std::uint8_t *cursor_end = nullptr;
+        mutable std::vector<std::int32_t> cursor_values;
+
+    public:
+        const FileHeader *header;
+
+        /**
+         * Pairs of points connected with sticks.
+         */
+        std::vector<std::pair<int, int>> sticks;
+
+        /**
+         * Ground of the recorded creature, nullptr for flat ground.
+         */
+        std::unique_ptr<Terrain> terrain;
+
+        /**
+         * Open a recording. Throws std::system_error if it can't be mapped or std::runtime_error if it is
+         * malformed. An incomplete last chunk (still being written) is ignored.
+         * @param path path to the file
+         */
+        explicit Reader(const std::string &path);
+
+        /**
+         * @return number of recorded frames
+         */
+        [[nodiscard]] long frame_count() const;
+
+        /**
+         * Decode positions of points in a frame.
+         * @param frame index of the frame, in [0, frame_count())
+         * @param positions receives header->point_count positions
+         */
+        void frame(long frame, std::vector<Vector2D> &positions) const;
+    };
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "ScenarioSet.h"
+
+ScenarioSet::ScenarioSet(std::vector<Scenario> scenarios, ThreadPool &pool, Run run, int objective_count)
+        : pool(pool), scenarios(std::move(scenarios)), run(std::move(run)), objective_count(objective_count) {
+    if (this->scenarios.empty()) {
+        throw std::invalid_argument("No scenarios given");
+    }
+    for (const auto &scenario: this->scenarios) {
+        if (scenario.input_count() != this->scenarios.front().input_count() ||
+            scenario.output_count() != this->scenarios.front().output_count()) {
+            throw std::invalid_argument("Scenarios have different numbers of network inputs or outputs");
+        }
+        templates.emplace_back(*create_creature(scenario, nullptr));
+    }
+    pooled.resize((std::size_t) pool.thread_count() * this->scenarios.size());
+    pooled_batches.resize(pooled.size());
+}
+
+std::vector<Vector2D> ScenarioSet::rotated_points(const Scenario &scenario) {
+    std::vector<Vector2D> points = scenario.points;
+    if (scenario.rotation != 0) {
+        Vector2D centre;
+        for (const auto &point: points) {
+            centre += point;
+        }
+        centre = centre / (double) points.size();
+
+        double c = std::cos(scenario.rotation);
+        double s = std::sin(scenario.rotation);
+        for (auto &point: points) {
+            Vector2D d = point - centre;
+            point = centre + Vector2D(d.x * c - d.y * s, d.x * s + d.y * c);
+        }
+    }
+    return points;
+}
+
+double ScenarioSet::aggregate(int genome, int objective, double *buffer) const {
+    const int count = (int) scenarios.size();
+    const int genome_count = (int) cutoffs.size();
+    for (int s = 0; s < count; s++) {
+        buffer[s] = scores[((std::size_t) s * genome_count + genome) * objective_count + objective];
+    }
+
+    switch (aggregation) {
+        case Aggregation::Mean:
+            return std::accumulate(buffer, buffer + count, 0.0) / count;
+        case Aggregation::Minimum:
+            return *std::min_element(buffer, buffer + count);
+        case Aggregation::WorstK: {
+            int k = std::clamp(worst_k, 1, count);
+            std::nth_element(buffer, buffer + k - 1, buffer + count);
+            return std::accumulate(buffer, buffer + k, 0.0) / k;
+        }
+    }
+    return 0;
+}
+
+void ScenarioSet::evaluate(const std::vector<NetworkGenome *> &genomes) {
+    const int genome_count = (int) genomes.size();
+    const int scenario_count = (int) scenarios.size();
+
+    for (const auto *genome: genomes) {
+        if (genome->input_count != scenarios.front().input_count() ||
+            genome->output_count != scenarios.front().output_count()) {
+            throw std::invalid_argument("Genome doesn't fit the sensors and muscles of the scenarios");
+        }
+    }
+
+    networks.resize(genome_count);
+    pool.parallel_for(genome_count, [this, &genomes](int i) {
+        networks[i] = std::make_unique<FastNetwork>(*genomes[i]);
+    });
+
+    // Scenario scores are compared with the cutoff only if each of them decides survival alone
+    const bool use_cutoffs = objective_count == 1 && (scenario_count == 1 || aggregation == Aggregation::Minimum);
+    cutoffs.assign(genome_count, -std::numeric_limits<double>::infinity());
+    for (int i = 0; use_cutoffs && i < genome_count; i++) {
+        cutoffs[i] = genomes[i]->population.survival_cutoff(*genomes[i]);
+    }
+
+    // Batches hold genomes of a single scenario, so items are built scenario by scenario
+    items.clear();
+    for (int s = 0; s < scenario_count; s++) {
+        const int size = batch_run && scenarios[s].collision_radius == 0 ? std::max(1, batch_size) : 1;
+        for (int first = 0; first < genome_count; first += size) {
+            items.push_back({s, first, std::min(size, genome_count - first)});
+        }
+    }
+
+    scores.assign((std::size_t) genome_count * scenario_count * objective_count, 0);
+    pool.parallel_for_slots((int) items.size(), [this](int item, int slot) {
+        run_item(items[item], slot);
+    });
+
+    std::vector<double> buffer(scenario_count);
+    for (int i = 0; i < genome_count; i++) {
+        NetworkGenome &genome = *genomes[i];
+        if (objective_count == 1) {
+            genome.fitness = aggregate(i, 0, buffer.data());
+        } else {
+            genome.objectives.resize(objective_count);
+            for (int o = 0; o < objective_count; o++) {
+                genome.objectives[o] = aggregate(i, o, buffer.data());
+            }
+        }
+    }
+
+    // Networks aren't needed until the next evaluation
+    networks.clear();
+}
+
+Creature &ScenarioSet::pooled_creature(int slot, int scenario, const FastNetwork *network) {
+    auto &creature = pooled[(std::size_t) slot * scenarios.size() + scenario];
+    if (creature == nullptr) {
+        creature = templates[scenario].instantiate(network);
+    } else {
+        templates[scenario].reset(*creature);
+        creature->attach(network);
+    }
+    return *creature;
+}
+
+void ScenarioSet::run_item(const WorkItem &item, int slot) {
+    const int s = item.scenario;
+    const Scenario &scenario = scenarios[s];
+    double *item_scores = &scores[((std::size_t) s * cutoffs.size() + item.first) * objective_count];
+    if (!batch_run || scenario.collision_radius > 0) {
+        run(pooled_creature(slot, s, networks[item.first].get()), scenario, cutoffs[item.first], item_scores);
+        return;
+    }
+
+    const int size = std::max(1, batch_size);
+    auto &batch = pooled_batches[(std::size_t) slot * scenarios.size() + s];
+    if (batch == nullptr || batch->count != size) {
+        batch = std::make_unique<CreatureBatch>(templates[s].initial, size);
+    }
+    for (int lane = 0; lane < size; lane++) {
+        const FastNetwork *network = lane < item.count ? networks[item.first + lane].get() : nullptr;
+        batch->load(lane, pooled_creature(slot, s, network));
+    }
+    batch->steps = templates[s].initial.steps;
+    batch_run(*batch, scenario, item.count, &cutoffs[item.first], item_scores);
+}
+
+void ScenarioSet::operator()(std::vector<NetworkGenome> &genomes) {
+    std::vector<NetworkGenome *> pointers;
+    pointers.reserve(genomes.size());
+    for (auto &genome: genomes) {
+        pointers.push_back(&genome);
+    }
+    evaluate(pointers);
+}
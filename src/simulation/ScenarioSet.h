@@ -0,0 +1,256 @@
+#ifndef NEAT_SCENARIOSET_H
+#define NEAT_SCENARIOSET_H
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Creature.h"
+#include "CreatureBatch.h"
+#include "CreatureTemplate.h"
+#include "Terrain.h"
+#include "../neat/NetworkGenome.h"
+#include "../utils/FastNetwork.h"
+#include "../utils/ThreadPool.h"
+
+/**
+ * Conditions a genome is evaluated in: creature morphology, starting pose, terrain and self-collision.
+ */
+struct Scenario {
+    std::vector<Vector2D> points;
+    std::vector<std::pair<int, int>> connections;
+
+    /**
+     * Indices of connections that are muscles, in the order of network outputs. All connections if empty.
+     */
+    std::vector<int> muscles;
+
+    /**
+     * Rotation of the creature around its centre (in radians), applied before placing it on the ground.
+     */
+    double rotation = 0;
+
+    /**
+     * Shift of the creature after placing it on the ground.
+     */
+    Vector2D offset;
+
+    /**
+     * Ground of the scenario, flat at height 0 if null.
+     */
+    std::shared_ptr<const Terrain> terrain;
+
+    /**
+     * Radius of colliding points, 0 if the creature passes through itself. (see Creature::collision_radius)
+     */
+    double collision_radius = 0;
+
+    /**
+     * @return number of inputs of networks controlling the creature (see Creature::sense)
+     */
+    [[nodiscard]] int input_count() const {
+        return Creature::sensor_count((int) points.size(), (int) connections.size());
+    }
+
+    /**
+     * @return number of outputs of networks controlling the creature, one per muscle
+     */
+    [[nodiscard]] int output_count() const {
+        return (int) (muscles.empty() ? connections.size() : muscles.size());
+    }
+};
+
+/**
+ * Method of combining scores of a genome in all scenarios.
+ */
+enum class Aggregation {
+    Mean,
+    Minimum,
+    WorstK /// mean of worst_k lowest scores
+};
+
+/**
+ * Evaluates every genome in every scenario.
+ *
+ * Networks are compiled once per genome, in parallel. Then every (genome, scenario) pair is a separate work
+ * item on the thread pool, creatures of all scenarios of a genome share its compiled network.
+ * Creatures are built once per scenario as templates when the set is created. Each worker keeps a creature
+ * per scenario, resets it to the template and attaches the network of its work item.
+ * Each work item writes its scores into its own slot, so scores are combined after all items finish without
+ * any locking.
+ *
+ * With batch_run set, genomes are simulated batch_size at a time in a CreatureBatch per scenario, so a work item
+ * is a batch of genomes in a scenario. Batches don't collide, scenarios with self-collision still use run.
+ *
+ * Scores are given by run, which simulates a creature in a scenario. With a single objective, aggregated
+ * score is the fitness, otherwise the aggregated scores are the objectives. Run gets the survival cutoff of the
+ * genome only when a single score decides survival: a single objective, and a single scenario or Minimum
+ * aggregation. Otherwise a score below the cutoff in one scenario could be made up in others.
+ *
+ * Can be used as population evaluation: Population(..., std::ref(scenario_set)).
+ */
+class ScenarioSet {
+public:
+    /**
+     * Function simulating a creature in a scenario and writing objective_count scores. Also gets the score the
+     * genome has to reach to survive in its species (see Population::survival_cutoff), -inf if it isn't known,
+     * so it can stop episodes that can't reach it. (see EpisodeController)
+     */
+    using Run = std::function<void(Creature &, const Scenario &, double, double *)>;
+
+    /**
+     * Function simulating the first lane count lanes of a batch in a scenario and writing objective_count scores
+     * per lane, lane after lane. Gets the survival cutoff of every lane. (see Run) Other lanes have no controller
+     * and their scores are ignored.
+     */
+    using BatchRun = std::function<void(CreatureBatch &, const Scenario &, int, const double *, double *)>;
+
+private:
+    ThreadPool &pool;
+
+    /**
+     * Compiled networks of evaluated genomes.
+     */
+    std::vector<std::unique_ptr<FastNetwork>> networks;
+
+    /**
+     * Initial state of the creature of each scenario.
+     */
+    std::vector<CreatureTemplate> templates;
+
+    /**
+     * Creatures reused by work items, one per thread pool slot and scenario, index slot * scenario count + scenario.
+     * Created on first use, then reset to their template.
+     */
+    std::vector<std::unique_ptr<Creature>> pooled;
+
+    /**
+     * Batches reused by work items, indexed like pooled. Created on first use, lanes are loaded from pooled creatures.
+     */
+    std::vector<std::unique_ptr<CreatureBatch>> pooled_batches;
+
+    /**
+     * Work item: count genomes starting with first in a scenario.
+     */
+    struct WorkItem {
+        int scenario;
+        int first;
+        int count;
+    };
+
+    std::vector<WorkItem> items;
+
+    /**
+     * Scores of all (genome, scenario) pairs, objective_count per pair, genomes of a scenario next to each other.
+     */
+    std::vector<double> scores;
+
+    /**
+     * Survival cutoff of every evaluated genome, passed to run.
+     */
+    std::vector<double> cutoffs;
+
+    /**
+     * Combine scores of a genome in all scenarios.
+     * @param genome index of the genome
+     * @param objective index of the objective
+     * @param buffer array of scenario count values
+     * @return aggregated score
+     */
+    double aggregate(int genome, int objective, double *buffer) const;
+
+    /**
+     * Get the creature of a thread pool slot in a scenario, reset to its template.
+     * @param slot slot of the calling worker
+     * @param scenario index of the scenario
+     * @param network network attached to the creature
+     * @return pooled creature
+     */
+    Creature &pooled_creature(int slot, int scenario, const FastNetwork *network);
+
+    /**
+     * Simulate a work item and write its scores.
+     * @param item
+     * @param slot slot of the calling worker
+     */
+    void run_item(const WorkItem &item, int slot);
+
+public:
+    std::vector<Scenario> scenarios;
+    Run run;
+    int objective_count;
+
+    /**
+     * Function simulating batches, run is used for every work item if empty.
+     */
+    BatchRun batch_run;
+
+    /**
+     * Number of lanes of a batch.
+     */
+    int batch_size = 16;
+
+    Aggregation aggregation = Aggregation::Mean;
+    int worst_k = 2;
+
+    /**
+     * Create a scenario set. All scenarios must have the same numbers of inputs and outputs, so one network fits
+     * all of them.
+     * @param scenarios scenarios, must not be empty
+     * @param pool threads running work items
+     * @param run function simulating a creature and scoring it
+     * @param objective_count number of scores written by run
+     */
+    ScenarioSet(std::vector<Scenario> scenarios, ThreadPool &pool, Run run, int objective_count = 1);
+
+    /**
+     * Calculate starting positions of points of a scenario, before placing the creature on the ground.
+     * @param scenario
+     * @return points rotated around their centre
+     */
+    static std::vector<Vector2D> rotated_points(const Scenario &scenario);
+
+    /**
+     * Create a creature placed in its starting pose.
+     * @tparam Scalar scalar type of the creature physics
+     * @param scenario
+     * @param network network controlling the creature, must outlive it
+     * @return new creature
+     */
+    template<typename Scalar = double>
+    static std::unique_ptr<BasicCreature<Scalar>> create_creature(const Scenario &scenario,
+                                                                  const FastNetwork *network) {
+        std::vector<Vector2D> points = rotated_points(scenario);
+
+        // Creature places itself on the ground
+        auto creature = network != nullptr
+                        ? std::make_unique<BasicCreature<Scalar>>(points, scenario.connections, network)
+                        : std::make_unique<BasicCreature<Scalar>>(points, scenario.connections);
+        if (!scenario.muscles.empty()) {
+            std::vector<std::pair<int, int>> muscles;
+            for (int connection: scenario.muscles) {
+                muscles.push_back(scenario.connections.at(connection));
+            }
+            creature->set_muscles(muscles);
+        }
+        creature->terrain = scenario.terrain.get();
+        creature->collision_radius = (Scalar) scenario.collision_radius;
+        const BasicVector2D<Scalar> offset(scenario.offset);
+        for (auto &point: creature->points) {
+            point.position += offset;
+            point.old_position += offset;
+        }
+        return creature;
+    }
+
+    /**
+     * Evaluate given genomes, setting fitness (single objective) or objectives.
+     * @param genomes genomes to evaluate
+     */
+    void evaluate(const std::vector<NetworkGenome *> &genomes);
+
+    void operator()(std::vector<NetworkGenome> &genomes);
+};
+
+#endif
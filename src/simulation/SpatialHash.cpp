@@ -0,0 +1,40 @@
+#include <algorithm>
+
+#include "SpatialHash.h"
+
+int SpatialHash::bucket(int cell_x, int cell_y) const {
+    const unsigned int hash = (unsigned int) cell_x * 73856093u ^ (unsigned int) cell_y * 19349663u;
+    return (int) (hash & (buckets.size() - 1));
+}
+
+void SpatialHash::clear(int item_count) {
+    // Power of two buckets, about two per item
+    std::size_t bucket_count = 16;
+    while (bucket_count < 2 * (std::size_t) item_count) {
+        bucket_count *= 2;
+    }
+    if (buckets.size() != bucket_count) buckets.resize(bucket_count);
+    for (auto &items: buckets) {
+        items.clear();
+    }
+    item_bucket.assign(item_count, -1);
+    item_slot.assign(item_count, 0);
+}
+
+void SpatialHash::update(int item, int cell_x, int cell_y) {
+    const int b = bucket(cell_x, cell_y);
+    const int old = item_bucket[item];
+    if (b == old) return;
+
+    if (old >= 0) {
+        // Swap with the last item of the bucket
+        auto &items = buckets[old];
+        const int moved = items.back();
+        items[item_slot[item]] = moved;
+        item_slot[moved] = item_slot[item];
+        items.pop_back();
+    }
+    item_bucket[item] = b;
+    item_slot[item] = (int) buckets[b].size();
+    buckets[b].push_back(item);
+}
@@ -0,0 +1,74 @@
+#ifndef NEAT_SPATIALHASH_H
+#define NEAT_SPATIALHASH_H
+
+#include <vector>
+
+/**
+ * Items indexed by cells of a uniform grid, for finding items near a position.
+ *
+ * Cells are hashed into a fixed number of buckets. Different cells can share a bucket, so a query returns
+ * every item near the position and maybe some others, which the caller filters.
+ * An item moves between buckets only when its bucket changes, so updating all items after a timestep is cheap,
+ * and buckets keep their capacity, so updates stop allocating after the first few timesteps.
+ */
+class SpatialHash {
+private:
+    std::vector<std::vector<int>> buckets;
+
+    /**
+     * Bucket of each item, -1 if the item is not in the hash.
+     */
+    std::vector<int> item_bucket;
+
+    /**
+     * Index of each item in its bucket.
+     */
+    std::vector<int> item_slot;
+
+    [[nodiscard]] int bucket(int cell_x, int cell_y) const;
+
+public:
+    /**
+     * Remove all items and prepare for item_count items, keeping the capacity of buckets.
+     * @param item_count items are numbered [0, item_count)
+     */
+    void clear(int item_count);
+
+    /**
+     * Insert an item, or move it to another cell.
+     * @param item
+     * @param cell_x
+     * @param cell_y
+     */
+    void update(int item, int cell_x, int cell_y);
+
+    /**
+     * Call a function with every item in the 3x3 cells around a cell, and maybe other items.
+     * Each item is visited once.
+     * @param cell_x
+     * @param cell_y
+     * @param function called with each item
+     */
+    template<typename Function>
+    void for_each_near(int cell_x, int cell_y, Function &&function) const {
+        int visited[9];
+        int visited_count = 0;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                const int b = bucket(cell_x + dx, cell_y + dy);
+                bool seen = false;
+                for (int i = 0; i < visited_count; i++) {
+                    seen = seen || visited[i] == b;
+                }
+                if (seen) continue;
+                visited[visited_count++] = b;
+
+                for (int item: buckets[b]) {
+                    function(item);
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -1,21 +1,66 @@
 #ifndef NEAT_STICK_H
 #define NEAT_STICK_H
 
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
 
 #include "Point.h"
 
 /**
  * Class representing sticks between points.
  */
-class Stick {
+template<typename Scalar>
+class BasicStick {
 public:
-    Point *ends[2];
-    double desired_length;
+    BasicPoint<Scalar> *ends[2];
+    Scalar desired_length;
 
-    Stick(Point &p1, Point &p2, double desired_length);
+    BasicStick(BasicPoint<Scalar> &p1, BasicPoint<Scalar> &p2, Scalar desired_length)
+            : ends{&p1, &p2}, desired_length(desired_length) {}
 
-    void constrain_points();
+    /**
+     * Move ends of the stick to the desired length.
+     * @param fast_inverse_sqrt use inverse_sqrt instead of a square root and a division
+     * @return relative length error before the correction, |d - desired_length| / d
+     */
+    Scalar constrain_points(bool fast_inverse_sqrt = false) {
+        BasicVector2D<Scalar> dist = ends[1]->position - ends[0]->position;
+        Scalar correction;
+        if (fast_inverse_sqrt) {
+            // (d - desired_length) / d / 2 without d
+            correction = (1 - desired_length * inverse_sqrt(dist.x * dist.x + dist.y * dist.y)) / 2;
+        } else {
+            Scalar d = dist.length();
+            correction = (d - desired_length) / d / 2;
+        }
+
+        ends[0]->position += dist * correction;
+        ends[1]->position += dist * -correction;
+        return std::abs(2 * correction);
+    }
+
+    /**
+     * Approximate 1 / sqrt(x) with the bit trick and two Newton steps (relative error below 1e-5).
+     * Only multiplications, so it is cheaper than a square root and a division, also when vectorised.
+     * @param x positive number
+     * @return approximate inverse square root
+     */
+    static constexpr Scalar inverse_sqrt(Scalar x) {
+        Scalar y;
+        if constexpr (std::is_same_v<Scalar, float>) {
+            y = std::bit_cast<float>(0x5f375a86 - (std::bit_cast<std::uint32_t>(x) >> 1));
+        } else {
+            y = std::bit_cast<double>(0x5fe6eb50c7b537a9 - (std::bit_cast<std::uint64_t>(x) >> 1));
+        }
+        const Scalar half = Scalar(0.5) * x;
+        y *= Scalar(1.5) - half * y * y;
+        y *= Scalar(1.5) - half * y * y;
+        return y;
+    }
 };
 
+using Stick = BasicStick<double>;
 
 #endif //NEAT_STICK_H
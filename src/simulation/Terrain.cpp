@@ -0,0 +1,33 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "Terrain.h"
+#include "../utils/Random.h"
+
+Terrain::Terrain(double start, double spacing, std::vector<double> heights)
+        : start(start), spacing(spacing), inverse_spacing(1 / spacing), heights(std::move(heights)) {
+    if (!(spacing > 0)) {
+        throw std::invalid_argument("Terrain spacing must be positive");
+    }
+    if (this->heights.size() < 2) {
+        throw std::invalid_argument("Terrain needs at least two samples");
+    }
+}
+
+Terrain Terrain::generate(std::uint64_t seed, double roughness, double length, double spacing, double flat) {
+    Random random(seed);
+    // Creatures start centred at x = 0, on flat ground from -flat to flat
+    const double start = -flat;
+    const int count = std::max(2, (int) ((length - start) / spacing) + 1);
+
+    std::vector<double> heights(count, 0);
+    double slope = 0;
+    for (int i = 1; i < count; i++) {
+        if (start + i * spacing <= flat) continue;
+        // Slopes stay below 35 degrees, so creatures can climb them
+        slope = std::clamp(slope + random.uniform(-roughness, roughness), -0.7, 0.7);
+        heights[i] = heights[i - 1] + slope * spacing;
+    }
+    return {start, spacing, std::move(heights)};
+}
@@ -0,0 +1,82 @@
+#ifndef NEAT_TERRAIN_H
+#define NEAT_TERRAIN_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Ground as a piecewise-linear heightfield: heights at x = start + i * spacing, linear in between and constant
+ * beyond both ends.
+ *
+ * Samples form a uniform grid, so the height at any x is found in O(1): the segment index is the scaled
+ * x rounded down, with no search.
+ */
+class Terrain {
+public:
+    double start;
+    double spacing;
+
+    /**
+     * 1 / spacing, so a lookup multiplies instead of dividing.
+     */
+    double inverse_spacing;
+
+    std::vector<double> heights;
+
+    /**
+     * Create a terrain from samples.
+     * @param start x of the first sample
+     * @param spacing distance between samples, positive
+     * @param heights at least two samples
+     */
+    Terrain(double start, double spacing, std::vector<double> heights);
+
+    /**
+     * Generate hilly terrain from a seed. Ground is flat at height 0 up to x = flat, where creatures start,
+     * then slopes change randomly every sample.
+     * @param seed seed of the random stream
+     * @param roughness largest change of slope between segments
+     * @param length x of the last sample
+     * @param spacing distance between samples
+     * @param flat x where the hills begin
+     * @return generated terrain
+     */
+    static Terrain generate(std::uint64_t seed, double roughness = 0.3, double length = 100, double spacing = 0.5,
+                            double flat = 2);
+
+    /**
+     * Calculate the height of the ground.
+     * @tparam Scalar scalar type of the query, samples are converted to it
+     * @param x
+     * @return height at x
+     */
+    template<typename Scalar>
+    [[nodiscard]] Scalar height(Scalar x) const {
+        const int last = (int) heights.size() - 1;
+        Scalar position = (x - (Scalar) start) * (Scalar) inverse_spacing;
+        // Comparisons are false for NaN, so an exploded creature reads the first sample, not outside the heights
+        position = position > 0 ? position : Scalar(0);
+        position = position < (Scalar) last ? position : (Scalar) last;
+        const int index = std::min((int) position, last - 1);
+        const Scalar h0 = (Scalar) heights[index];
+        const Scalar h1 = (Scalar) heights[index + 1];
+        return h0 + (h1 - h0) * (position - (Scalar) index);
+    }
+
+    /**
+     * Calculate heights of the ground at many positions, in one loop without branches.
+     * @tparam Scalar scalar type of the query
+     * @param x array of count positions
+     * @param ground array receiving count heights
+     * @param count
+     */
+    template<typename Scalar>
+    void height(const Scalar *x, Scalar *ground, int count) const {
+        for (int i = 0; i < count; i++) {
+            ground[i] = height(x[i]);
+        }
+    }
+};
+
+#endif
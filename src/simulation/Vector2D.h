@@ -1,29 +1,68 @@
 #ifndef NEAT_VECTOR2D_H
 #define NEAT_VECTOR2D_H
 
-#include <SFML/Graphics.hpp>
+#include <cmath>
 
 /**
- * Class for vector operations.
+ * Class for vector operations, on a given scalar type (float or double).
+ * Operators are defined in the header, so they are inlined into physics loops without LTO.
  */
-class Vector2D {
+template<typename Scalar>
+class BasicVector2D {
 public:
-    double x = 0;
-    double y = 0;
+    Scalar x = 0;
+    Scalar y = 0;
 
-    Vector2D &operator+=(const Vector2D& vector);
-    Vector2D &operator*=(double d);
-    [[nodiscard]] Vector2D operator*(double d) const;
-    [[nodiscard]] Vector2D operator/(double d) const;
-    [[nodiscard]] Vector2D operator-(const Vector2D& vector) const;
-    [[nodiscard]] Vector2D operator+(const Vector2D& vector) const;
-    [[nodiscard]] double length() const;
+    constexpr BasicVector2D &operator+=(const BasicVector2D &vector) {
+        x += vector.x;
+        y += vector.y;
+        return *this;
+    }
 
-    [[nodiscard]] sf::Vector2f to_screen_space(int width, int height) const;
+    constexpr BasicVector2D &operator-=(const BasicVector2D &vector) {
+        x -= vector.x;
+        y -= vector.y;
+        return *this;
+    }
 
-    Vector2D(double x, double y);
-    Vector2D() = default;
+    constexpr BasicVector2D &operator*=(Scalar d) {
+        x *= d;
+        y *= d;
+        return *this;
+    }
+
+    [[nodiscard]] constexpr BasicVector2D operator*(Scalar d) const {
+        return {x * d, y * d};
+    }
+
+    [[nodiscard]] constexpr BasicVector2D operator/(Scalar d) const {
+        return {x / d, y / d};
+    }
+
+    [[nodiscard]] constexpr BasicVector2D operator-(const BasicVector2D &vector) const {
+        return {x - vector.x, y - vector.y};
+    }
+
+    [[nodiscard]] constexpr BasicVector2D operator+(const BasicVector2D &vector) const {
+        return {x + vector.x, y + vector.y};
+    }
+
+    [[nodiscard]] Scalar length() const {
+        return std::sqrt(x * x + y * y);
+    }
+
+    constexpr BasicVector2D(Scalar x, Scalar y) : x(x), y(y) {}
+
+    constexpr BasicVector2D() = default;
+
+    /**
+     * Convert a vector of another scalar type.
+     */
+    template<typename Other>
+    constexpr explicit BasicVector2D(const BasicVector2D<Other> &vector) : x((Scalar) vector.x), y((Scalar) vector.y) {}
 };
 
+using Vector2D = BasicVector2D<double>;
+using Vector2F = BasicVector2D<float>;
 
 #endif //NEAT_VECTOR2D_H
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <memory>
+
+#include "Arena.h"
+
+Arena::Arena(std::size_t initial_size) {
+    grow(initial_size);
+}
+
+Arena::~Arena() {
+    for (const auto &block: blocks) {
+        delete[] block.data;
+    }
+}
+
+void Arena::grow(std::size_t size) {
+    blocks.push_back({new std::byte[size], size});
+    offset = 0;
+    heap_allocations++;
+}
+
+void *Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    while (true) {
+        Block &block = blocks.back();
+        void *p = block.data + offset;
+        std::size_t space = block.size - offset;
+
+        if (std::align(alignment, bytes, p, space)) {
+            offset = (std::byte *) p - block.data + bytes;
+            return p;
+        }
+
+        // Current block is full, at least double the capacity
+        grow(std::max(bytes + alignment, 2 * block.size));
+    }
+}
+
+void Arena::do_deallocate(void *, std::size_t, std::size_t) {
+    // Memory is released only by reset
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+void Arena::reset() {
+    if (blocks.size() > 1) {
+        // Merge blocks so that next time everything fits in one
+        std::size_t size = capacity();
+        for (const auto &block: blocks) {
+            delete[] block.data;
+        }
+        blocks.clear();
+        grow(size);
+    }
+
+    offset = 0;
+}
+
+std::size_t Arena::capacity() const {
+    std::size_t size = 0;
+    for (const auto &block: blocks) {
+        size += block.size;
+    }
+    return size;
+}
+
+std::size_t Arena::allocation_count() const {
+    return heap_allocations;
+}
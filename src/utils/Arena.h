@@ -0,0 +1,83 @@
+#ifndef NEAT_ARENA_H
+#define NEAT_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * Bump allocator used as storage for a whole generation of genomes.
+ *
+ * Memory is handed out by advancing an offset in the current block, deallocation is a no-op.
+ * All memory is released at once with reset(), which keeps the blocks for reuse, so once the arena has grown
+ * to the size of a generation it doesn't touch the heap anymore.
+ */
+class Arena : public std::pmr::memory_resource {
+private:
+    struct Block {
+        std::byte *data;
+        std::size_t size;
+    };
+
+    /**
+     * Blocks allocated from the heap. Allocation happens from the last one.
+     */
+    std::vector<Block> blocks;
+
+    /**
+     * Number of bytes used in the last block.
+     */
+    std::size_t offset = 0;
+
+    /**
+     * Number of blocks allocated from the heap since the arena was created.
+     */
+    std::size_t heap_allocations = 0;
+
+    /**
+     * Allocate a new block of at least given size and make it the current one.
+     * @param size minimal size of the block
+     */
+    void grow(std::size_t size);
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+public:
+    /**
+     * Create an arena with a single block.
+     * @param initial_size size of the first block in bytes
+     */
+    explicit Arena(std::size_t initial_size = 1 << 16);
+
+    Arena(const Arena &) = delete;
+
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena() override;
+
+    /**
+     * Release all memory allocated from the arena.
+     * If the arena had to grow, blocks are merged into a single one big enough to hold everything at once.
+     */
+    void reset();
+
+    /**
+     * Calculate total size of all blocks.
+     * @return capacity in bytes
+     */
+    [[nodiscard]] std::size_t capacity() const;
+
+    /**
+     * Get number of heap allocations made by the arena so far.
+     * @return number of allocated blocks
+     */
+    [[nodiscard]] std::size_t allocation_count() const;
+};
+
+
+#endif //NEAT_ARENA_H
@@ -0,0 +1,88 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "Bytes.h"
+
+ByteWriter::ByteWriter(std::vector<std::uint8_t> &buffer) : buffer(buffer) {}
+
+void ByteWriter::write_varint(std::uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back((std::uint8_t) (value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((std::uint8_t) value);
+}
+
+void ByteWriter::write_signed(std::int64_t value) {
+    write_varint(((std::uint64_t) value << 1) ^ (std::uint64_t) (value >> 63));
+}
+
+void ByteWriter::write_double(double value) {
+    write_bytes(&value, sizeof(value));
+}
+
+void ByteWriter::write_byte(std::uint8_t value) {
+    buffer.push_back(value);
+}
+
+void ByteWriter::write_bytes(const void *data, std::size_t size) {
+    const auto *bytes = (const std::uint8_t *) data;
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void ByteWriter::write_string(const std::string &value) {
+    write_varint(value.size());
+    write_bytes(value.data(), value.size());
+}
+
+ByteReader::ByteReader(const std::uint8_t *data, std::size_t size) : data(data), end(data + size) {}
+
+void ByteReader::require(std::size_t size) const {
+    if (remaining() < size) {
+        throw std::runtime_error("Unexpected end of data");
+    }
+}
+
+std::uint64_t ByteReader::read_varint() {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        std::uint8_t byte = read_byte();
+        value |= (std::uint64_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("Malformed varint");
+}
+
+std::int64_t ByteReader::read_signed() {
+    std::uint64_t value = read_varint();
+    return (std::int64_t) (value >> 1) ^ -(std::int64_t) (value & 1);
+}
+
+double ByteReader::read_double() {
+    double value;
+    read_bytes(&value, sizeof(value));
+    return value;
+}
+
+std::uint8_t ByteReader::read_byte() {
+    require(1);
+    return *data++;
+}
+
+void ByteReader::read_bytes(void *destination, std::size_t size) {
+    require(size);
+    std::memcpy(destination, data, size);
+    data += size;
+}
+
+std::string ByteReader::read_string() {
+    std::size_t size = read_varint();
+    require(size);
+    std::string value((const char *) data, size);
+    data += size;
+    return value;
+}
+
+std::size_t ByteReader::remaining() const {
+    return end - data;
+}
@@ -0,0 +1,69 @@
+#ifndef NEAT_BYTES_H
+#define NEAT_BYTES_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Appends values to a byte buffer in a compact little endian encoding.
+ * Integers are written as LEB128 varints, signed integers are zigzag encoded first.
+ */
+class ByteWriter {
+public:
+    std::vector<std::uint8_t> &buffer;
+
+    explicit ByteWriter(std::vector<std::uint8_t> &buffer);
+
+    void write_varint(std::uint64_t value);
+
+    void write_signed(std::int64_t value);
+
+    void write_double(double value);
+
+    void write_byte(std::uint8_t value);
+
+    void write_bytes(const void *data, std::size_t size);
+
+    /**
+     * Write a string prefixed with its length.
+     * @param value
+     */
+    void write_string(const std::string &value);
+};
+
+/**
+ * Reads values written by ByteWriter from a memory range.
+ * Reading past the end throws std::runtime_error.
+ */
+class ByteReader {
+private:
+    /**
+     * Throw if fewer than size bytes are left.
+     * @param size number of bytes about to be read
+     */
+    void require(std::size_t size) const;
+
+public:
+    const std::uint8_t *data;
+    const std::uint8_t *end;
+
+    ByteReader(const std::uint8_t *data, std::size_t size);
+
+    std::uint64_t read_varint();
+
+    std::int64_t read_signed();
+
+    double read_double();
+
+    std::uint8_t read_byte();
+
+    void read_bytes(void *destination, std::size_t size);
+
+    std::string read_string();
+
+    [[nodiscard]] std::size_t remaining() const;
+};
+
+
+#endif //NEAT_BYTES_H
@@ -1,3 +1,4 @@
+#include <cmath>
 #include <stack>
 #include <iostream>
 #include "FastNetwork.h"
@@ -42,19 +43,23 @@ FastNetwork::~FastNetwork() {
 }
 
 double *FastNetwork::calculate(const double *inputs) const {
+    return calculate(inputs, values);
+}
+
+double *FastNetwork::calculate(const double *inputs, double *buffer) const {
     for(int i = 0; i < input_count; i++) {
-        values[i] = inputs[i];
+        buffer[i] = inputs[i];
     }
 
     for(int i = input_count; i < node_count; i++) {
-        values[i] = 0;
+        buffer[i] = 0;
         for(const auto& [from, weight] : connections[i]) {
-            values[i] += values[from] * weight;
+            buffer[i] += buffer[from] * weight;
         }
-        values[i] = activation(values[i]);
+        buffer[i] = activation(buffer[i]);
     }
 
-    return values + node_count - output_count;
+    return buffer + node_count - output_count;
 }
 
 double FastNetwork::activation(double x) {
@@ -45,6 +45,14 @@ public:
      */
     double * calculate(const double * inputs) const;
 
+    /**
+     * Calculate values of nodes in a given buffer. Doesn't modify the network, so threads can share it.
+     * @param inputs input node values
+     * @param buffer array of node_count values
+     * @return pointer to output values (points at some location in buffer)
+     */
+    double *calculate(const double *inputs, double *buffer) const;
+
     /**
      * Activation function on each node.
      * @param x argument
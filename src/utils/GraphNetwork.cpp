@@ -1,5 +1,6 @@
 #include <queue>
 #include <algorithm>
+#include <cmath>
 #include <stack>
 #include <iostream>
 
@@ -63,7 +64,7 @@ int *GraphNetwork::evaluation_order() const {
 }
 
 
-std::pair<int, int> GraphNetwork::get_new_random_connection(std::default_random_engine &engine) const {
+std::pair<int, int> GraphNetwork::get_new_random_connection(Random &engine) const {
     // Set with all nodes from which connection can be created
     auto nodes_possible = nodes;
     erase_if(nodes_possible, [this](const auto &node) { return output.contains(node); });
@@ -83,7 +84,7 @@ std::pair<int, int> GraphNetwork::get_new_random_connection(std::default_random_
     return {};
 }
 
-std::pair<int, int> GraphNetwork::get_new_random_connection_from(int from, std::default_random_engine &engine) const {
+std::pair<int, int> GraphNetwork::get_new_random_connection_from(int from, Random &engine) const {
     // Set with all nodes to which connection can be created
     std::set<int> nodes_possible = nodes;
 
@@ -122,10 +123,9 @@ std::set<int> GraphNetwork::get_previous_nodes(int node) const {
     return previous;
 }
 
-int GraphNetwork::random_from_set(const std::set<int> &set, std::default_random_engine &engine) {
+int GraphNetwork::random_from_set(const std::set<int> &set, Random &engine) {
     // Get random index of node
-    std::uniform_int_distribution<int> distribution(0, (int) set.size() - 1);
-    int index = distribution(engine);
+    int index = engine.integer((int) set.size());
 
     // Get a node in sequence
     for (int node : set) {
@@ -2,9 +2,9 @@
 #define NEAT_GRAPHNETWORK_H
 
 #include <set>
-#include <random>
 
 #include "../neat/NetworkGenome.h"
+#include "Random.h"
 
 /**
  * Utility class containing graphing algorithms and used for visualisation.
@@ -70,7 +70,7 @@ public:
      * @param engine random number engine
      * @return pair containing the connection (first is from, second is to)(std::pair<int, int>() if cannot be found)
      */
-    [[nodiscard]] std::pair<int, int> get_new_random_connection(std::default_random_engine& engine) const;
+    [[nodiscard]] std::pair<int, int> get_new_random_connection(Random &engine) const;
 
     /**
      * Get a random connection that is not present in the network leading from a given from.
@@ -78,7 +78,7 @@ public:
      * @param engine random number engine
      * @return pair containing the connection (first is from, second is to) (std::pair<int, int>() if cannot be found)
      */
-    [[nodiscard]] std::pair<int, int> get_new_random_connection_from(int from, std::default_random_engine& engine) const;
+    [[nodiscard]] std::pair<int, int> get_new_random_connection_from(int from, Random &engine) const;
 
 
     /**
@@ -87,7 +87,7 @@ public:
      * @param engine random engine
      * @return a random node
      */
-    static int random_from_set(const std::set<int> &set, std::default_random_engine& engine);
+    static int random_from_set(const std::set<int> &set, Random &engine);
 
     /**
      * Calculate the biggest id of nodes.
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <numeric>
+
+#include "KDTree.h"
+
+KDTree::KDTree(int dimensions) : dimensions(dimensions) {}
+
+double KDTree::squared_distance(const double *a, const double *b, int dimensions) {
+    double sum = 0;
+    for (int i = 0; i < dimensions; i++) {
+        double d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+void KDTree::offer(std::vector<double> &nearest, int k, double distance) {
+    if ((int) nearest.size() < k) {
+        nearest.push_back(distance);
+        std::push_heap(nearest.begin(), nearest.end());
+    } else if (distance < nearest.front()) {
+        std::pop_heap(nearest.begin(), nearest.end());
+        nearest.back() = distance;
+        std::push_heap(nearest.begin(), nearest.end());
+    }
+}
+
+void KDTree::build(const std::vector<double> &coordinates) {
+    const int n = (int) coordinates.size() / dimensions;
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    split.assign(n, 0);
+    build(0, n, order, coordinates);
+
+    points.resize(coordinates.size());
+    for (int i = 0; i < n; i++) {
+        std::copy_n(coordinates.begin() + (long) order[i] * dimensions, dimensions,
+                    points.begin() + (long) i * dimensions);
+    }
+}
+
+void KDTree::build(int first, int last, std::vector<int> &order, const std::vector<double> &source) {
+    if (last - first <= 1) return;
+
+    // Split along the dimension with the largest spread
+    int dimension = 0;
+    double spread = -1;
+    for (int d = 0; d < dimensions; d++) {
+        auto [min, max] = std::minmax_element(order.begin() + first, order.begin() + last, [&](int a, int b) {
+            return source[(long) a * dimensions + d] < source[(long) b * dimensions + d];
+        });
+        double s = source[(long) *max * dimensions + d] - source[(long) *min * dimensions + d];
+        if (s > spread) {
+            spread = s;
+            dimension = d;
+        }
+    }
+
+    int middle = (first + last) / 2;
+    std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + last, [&](int a, int b) {
+        return source[(long) a * dimensions + dimension] < source[(long) b * dimensions + dimension];
+    });
+    split[middle] = dimension;
+
+    build(first, middle, order, source);
+    build(middle + 1, last, order, source);
+}
+
+void KDTree::nearest(const double *query, int k, std::vector<double> &nearest) const {
+    search(0, size(), query, k, nearest);
+}
+
+void KDTree::search(int first, int last, const double *query, int k, std::vector<double> &nearest) const {
+    if (first >= last) return;
+
+    int middle = (first + last) / 2;
+    const double *point = points.data() + (long) middle * dimensions;
+    offer(nearest, k, squared_distance(query, point, dimensions));
+    if (last - first == 1) return;
+
+    // Visit the side containing the query first, the other one only if it can contain closer points
+    double difference = query[split[middle]] - point[split[middle]];
+    if (difference < 0) {
+        search(first, middle, query, k, nearest);
+        if ((int) nearest.size() < k || difference * difference < nearest.front()) {
+            search(middle + 1, last, query, k, nearest);
+        }
+    } else {
+        search(middle + 1, last, query, k, nearest);
+        if ((int) nearest.size() < k || difference * difference < nearest.front()) {
+            search(first, middle, query, k, nearest);
+        }
+    }
+}
+
+int KDTree::size() const {
+    return (int) split.size();
+}
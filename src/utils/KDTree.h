@@ -0,0 +1,72 @@
+#ifndef NEAT_KDTREE_H
+#define NEAT_KDTREE_H
+
+#include <utility>
+#include <vector>
+
+/**
+ * Static k-d tree over points of a fixed dimension, used for nearest neighbour queries.
+ *
+ * Points are stored in a flat array and reordered so that every subtree occupies a contiguous range,
+ * with the splitting point in the middle of the range. Building takes O(n log n),
+ * a k nearest neighbours query takes O(log n) on average for low dimensions.
+ */
+class KDTree {
+private:
+    int dimensions;
+
+    /**
+     * Coordinates of points, dimensions values per point, in tree order.
+     */
+    std::vector<double> points;
+
+    /**
+     * Splitting dimension of the node in the middle of each range (indexed by point).
+     */
+    std::vector<int> split;
+
+    /**
+     * Order points in range [first, last) into a subtree.
+     */
+    void build(int first, int last, std::vector<int> &order, const std::vector<double> &source);
+
+    /**
+     * Search subtree in range [first, last) for nearest neighbours.
+     */
+    void search(int first, int last, const double *query, int k, std::vector<double> &nearest) const;
+
+public:
+    /**
+     * Calculate squared euclidean distance of two points.
+     */
+    static double squared_distance(const double *a, const double *b, int dimensions);
+
+    /**
+     * Insert a squared distance into a max-heap of k smallest distances.
+     * @param nearest heap of distances
+     * @param k maximal heap size
+     * @param distance squared distance
+     */
+    static void offer(std::vector<double> &nearest, int k, double distance);
+
+    explicit KDTree(int dimensions = 1);
+
+    /**
+     * Build the tree from given points, replacing previous content.
+     * @param coordinates coordinates of points, dimensions values per point
+     */
+    void build(const std::vector<double> &coordinates);
+
+    /**
+     * Find squared distances to k nearest points, merging them into a heap (see offer).
+     * @param query coordinates of the query point
+     * @param k number of neighbours
+     * @param nearest max-heap of squared distances, may already contain candidates from elsewhere
+     */
+    void nearest(const double *query, int k, std::vector<double> &nearest) const;
+
+    [[nodiscard]] int size() const;
+};
+
+
+#endif //NEAT_KDTREE_H
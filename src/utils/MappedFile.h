@@ -0,0 +1,38 @@
+#ifndef NEAT_MAPPEDFILE_H
+#define NEAT_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Read-only memory mapping of a whole file.
+ */
+class MappedFile {
+private:
+    void *memory = nullptr;
+    std::size_t length = 0;
+
+public:
+    /**
+     * Map a file. Throws std::system_error if it can't be opened or mapped.
+     * @param path path to the file
+     */
+    explicit MappedFile(const std::string &path);
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile();
+
+    /**
+     * @return pointer to the mapped content (nullptr for an empty file)
+     */
+    [[nodiscard]] const std::uint8_t *data() const;
+
+    [[nodiscard]] std::size_t size() const;
+};
+
+
+#endif //NEAT_MAPPEDFILE_H
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <random>
+
+#include "Random.h"
+
+namespace {
+    std::uint64_t rotate_left(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t splitmix64(std::uint64_t &x) {
+        std::uint64_t z = (x += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+}
+
+Random::Random(std::uint64_t seed) {
+    for (auto &lane_word: state) {
+        for (auto &word: lane_word) {
+            word = splitmix64(seed);
+        }
+    }
+    refill();
+}
+
+Random &Random::local() {
+    static std::atomic<std::uint64_t> next_seed(std::random_device{}());
+    thread_local Random random(next_seed.fetch_add(0x9e3779b97f4a7c15));
+    return random;
+}
+
+void Random::refill() {
+    std::memcpy(block_state, state, sizeof(state));
+
+    auto &s0 = state[0];
+    auto &s1 = state[1];
+    auto &s2 = state[2];
+    auto &s3 = state[3];
+    for (int i = 0; i < buffer_size; i += lane_count) {
+        for (int lane = 0; lane < lane_count; lane++) {
+            buffer[i + lane] = rotate_left(s0[lane] + s3[lane], 23) + s0[lane];
+
+            std::uint64_t t = s1[lane] << 17;
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = rotate_left(s3[lane], 45);
+        }
+    }
+    position = 0;
+}
+
+int Random::integer(int n) {
+    auto range = (std::uint32_t) n;
+    std::uint64_t product = ((*this)() >> 32) * range;
+    auto low = (std::uint32_t) product;
+    if (low < range) {
+        // Reject the values that would make some results more likely
+        std::uint32_t threshold = -range % range;
+        while (low < threshold) {
+            product = ((*this)() >> 32) * range;
+            low = (std::uint32_t) product;
+        }
+    }
+    return (int) (product >> 32);
+}
+
+double Random::normal(double mean, double deviation) {
+    if (has_spare_normal) {
+        has_spare_normal = false;
+        return mean + deviation * spare_normal;
+    }
+
+    double u, v, s;
+    do {
+        u = uniform(-1, 1);
+        v = uniform(-1, 1);
+        s = u * u + v * v;
+    } while (s >= 1 || s == 0);
+
+    double factor = std::sqrt(-2 * std::log(s) / s);
+    spare_normal = v * factor;
+    has_spare_normal = true;
+    return mean + deviation * u * factor;
+}
+
+void Random::uniform(double *values, int count, double low, double high) {
+    const double scale = (high - low) * 0x1.0p-53;
+    while (count > 0) {
+        if (position == buffer_size) refill();
+        int n = std::min(count, buffer_size - position);
+        const std::uint64_t *bits = buffer + position;
+        for (int i = 0; i < n; i++) {
+            values[i] = low + (double) (bits[i] >> 11) * scale;
+        }
+        position += n;
+        values += n;
+        count -= n;
+    }
+}
+
+void Random::normal(double *values, int count, double mean, double deviation) {
+    for (int i = 0; i < count; i++) {
+        values[i] = normal(mean, deviation);
+    }
+}
+
+void Random::bernoulli(bool *values, int count, double probability) {
+    if (probability <= 0 || probability >= 1) {
+        std::fill(values, values + count, probability >= 1);
+        return;
+    }
+
+    // Compare bits directly with probability scaled to 2^64
+    const auto threshold = (std::uint64_t) (probability * 0x1.0p64);
+    while (count > 0) {
+        if (position == buffer_size) refill();
+        int n = std::min(count, buffer_size - position);
+        const std::uint64_t *bits = buffer + position;
+        for (int i = 0; i < n; i++) {
+            values[i] = bits[i] < threshold;
+        }
+        position += n;
+        values += n;
+        count -= n;
+    }
+}
+
+std::ostream &operator<<(std::ostream &stream, const Random &random) {
+    for (const auto &lane_word: random.block_state) {
+        for (auto word: lane_word) {
+            stream << word << ' ';
+        }
+    }
+    std::uint64_t spare;
+    std::memcpy(&spare, &random.spare_normal, sizeof(spare));
+    return stream << random.position << ' ' << random.has_spare_normal << ' ' << spare;
+}
+
+std::istream &operator>>(std::istream &stream, Random &random) {
+    for (auto &lane_word: random.state) {
+        for (auto &word: lane_word) {
+            stream >> word;
+        }
+    }
+    int position;
+    std::uint64_t spare;
+    stream >> position >> random.has_spare_normal >> spare;
+    std::memcpy(&random.spare_normal, &spare, sizeof(spare));
+
+    // Regenerate the buffer the stream was reading from
+    random.refill();
+    random.position = std::clamp(position, 0, Random::buffer_size);
+    return stream;
+}
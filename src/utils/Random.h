@@ -0,0 +1,156 @@
+#ifndef NEAT_RANDOM_H
+#define NEAT_RANDOM_H
+
+#include <cstdint>
+#include <iosfwd>
+
+/**
+ * Buffered random number stream based on xoshiro256++ (see Blackman and Vigna, Scrambled Linear Pseudorandom
+ * Number Generators).
+ *
+ * Runs lane_count independent xoshiro256++ generators, stored lane by lane, so refilling the buffer is a simple
+ * loop the compiler vectorises. Single draws only read the buffer. Distributions are plain functions
+ * of the drawn bits, so there are no distribution objects to construct.
+ *
+ * Satisfies UniformRandomBitGenerator, so it can be passed to standard algorithms (like std::shuffle).
+ * A stream must not be shared by threads, use local() for a stream owned by the calling thread.
+ */
+class Random {
+public:
+    static constexpr int lane_count = 4;
+    static constexpr int buffer_size = 256;
+
+private:
+    /**
+     * State of lanes, state[word][lane].
+     */
+    alignas(32) std::uint64_t state[4][lane_count];
+
+    /**
+     * State the current buffer was generated from, restored when reading a saved stream.
+     */
+    std::uint64_t block_state[4][lane_count];
+
+    alignas(32) std::uint64_t buffer[buffer_size];
+    int position = buffer_size;
+
+    /**
+     * Cached second value of the last normal draw.
+     */
+    double spare_normal = 0;
+    bool has_spare_normal = false;
+
+    /**
+     * Generate the next buffer_size numbers.
+     */
+    void refill();
+
+public:
+    using result_type = std::uint64_t;
+
+    /**
+     * Create a stream. Lanes are seeded with splitmix64 sequence started from the seed.
+     * @param seed seed of the stream
+     */
+    explicit Random(std::uint64_t seed = 0);
+
+    /**
+     * Get a stream owned by the calling thread, seeded differently for each thread.
+     * @return thread local stream
+     */
+    static Random &local();
+
+    static constexpr result_type min() { return 0; }
+
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    /**
+     * Draw 64 random bits.
+     * @return random bits
+     */
+    result_type operator()() {
+        if (position == buffer_size) refill();
+        return buffer[position++];
+    }
+
+    /**
+     * Draw a number uniformly from [0, 1).
+     * @return random number
+     */
+    double uniform() {
+        return (double) ((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * Draw a number uniformly from [low, high).
+     * @param low
+     * @param high
+     * @return random number
+     */
+    double uniform(double low, double high) {
+        return low + (high - low) * uniform();
+    }
+
+    /**
+     * Draw an integer uniformly from [0, n) without modulo bias. (see Lemire, Fast Random Integer Generation
+     * in an Interval)
+     * @param n number of possible values, must be positive
+     * @return random integer
+     */
+    int integer(int n);
+
+    /**
+     * Draw true with a given probability.
+     * @param probability
+     * @return random bool
+     */
+    bool bernoulli(double probability) {
+        return uniform() < probability;
+    }
+
+    /**
+     * Draw a number from the normal distribution (Marsaglia polar method).
+     * @param mean
+     * @param deviation standard deviation
+     * @return random number
+     */
+    double normal(double mean = 0, double deviation = 1);
+
+    /**
+     * Fill an array with numbers drawn uniformly from [low, high).
+     * @param values array to fill
+     * @param count number of values
+     * @param low
+     * @param high
+     */
+    void uniform(double *values, int count, double low = 0, double high = 1);
+
+    /**
+     * Fill an array with numbers drawn from the normal distribution.
+     * @param values array to fill
+     * @param count number of values
+     * @param mean
+     * @param deviation standard deviation
+     */
+    void normal(double *values, int count, double mean = 0, double deviation = 1);
+
+    /**
+     * Fill an array with Bernoulli draws.
+     * @param values array to fill
+     * @param count number of values
+     * @param probability probability of true
+     */
+    void bernoulli(bool *values, int count, double probability);
+
+    /**
+     * Write the state of the stream.
+     */
+    friend std::ostream &operator<<(std::ostream &stream, const Random &random);
+
+    /**
+     * Read the state of the stream, continuing exactly where the written stream was.
+     */
+    friend std::istream &operator>>(std::istream &stream, Random &random);
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <sys/mman.h>
+
+#include "SharedMemory.h"
+
+SharedMemory::SharedMemory(std::size_t size) : length(size) {
+    memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::system_error(errno, std::generic_category(), "mmap");
+    }
+}
+
+SharedMemory::~SharedMemory() {
+    munmap(memory, length);
+}
+
+std::uint8_t *SharedMemory::data() const {
+    return (std::uint8_t *) memory;
+}
+
+std::size_t SharedMemory::size() const {
+    return length;
+}
+
+std::size_t SharedRing::required_size(std::size_t capacity) {
+    return sizeof(Header) + capacity;
+}
+
+SharedRing::SharedRing(std::uint8_t *memory, std::size_t capacity, bool initialise)
+        : header((Header *) memory), buffer(memory + sizeof(Header)) {
+    if (initialise) {
+        new(header) Header{{0}, {0}, capacity};
+    }
+}
+
+void SharedRing::copy_in(std::uint64_t position, const void *data, std::size_t size) {
+    std::size_t offset = position % header->capacity;
+    std::size_t first = std::min(size, header->capacity - offset);
+    std::memcpy(buffer + offset, data, first);
+    std::memcpy(buffer, (const std::uint8_t *) data + first, size - first);
+}
+
+void SharedRing::copy_out(std::uint64_t position, void *data, std::size_t size) const {
+    std::size_t offset = position % header->capacity;
+    std::size_t first = std::min(size, header->capacity - offset);
+    std::memcpy(data, buffer + offset, first);
+    std::memcpy((std::uint8_t *) data + first, buffer, size - first);
+}
+
+bool SharedRing::push(const void *data, std::uint32_t size) {
+    std::uint64_t head = header->head.load(std::memory_order_relaxed);
+    std::uint64_t tail = header->tail.load(std::memory_order_acquire);
+    if (head - tail + sizeof(size) + size > header->capacity) return false;
+
+    copy_in(head, &size, sizeof(size));
+    copy_in(head + sizeof(size), data, size);
+
+    // Publish the message
+    header->head.store(head + sizeof(size) + size, std::memory_order_release);
+    return true;
+}
+
+bool SharedRing::pop(std::vector<std::uint8_t> &message) {
+    std::uint64_t tail = header->tail.load(std::memory_order_relaxed);
+    std::uint64_t head = header->head.load(std::memory_order_acquire);
+    if (head == tail) return false;
+
+    std::uint32_t size;
+    copy_out(tail, &size, sizeof(size));
+    message.resize(size);
+    copy_out(tail + sizeof(size), message.data(), size);
+
+    // Free the space for the producer
+    header->tail.store(tail + sizeof(size) + size, std::memory_order_release);
+    return true;
+}
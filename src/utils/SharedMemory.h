@@ -0,0 +1,95 @@
+#ifndef NEAT_SHAREDMEMORY_H
+#define NEAT_SHAREDMEMORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Anonymous memory mapping shared with processes forked after its creation.
+ */
+class SharedMemory {
+private:
+    void *memory;
+    std::size_t length;
+
+public:
+    /**
+     * Map zero initialised shared memory. Throws std::system_error on failure.
+     * @param size size in bytes
+     */
+    explicit SharedMemory(std::size_t size);
+
+    SharedMemory(const SharedMemory &) = delete;
+
+    SharedMemory &operator=(const SharedMemory &) = delete;
+
+    ~SharedMemory();
+
+    [[nodiscard]] std::uint8_t *data() const;
+
+    [[nodiscard]] std::size_t size() const;
+};
+
+/**
+ * Lock-free single producer, single consumer queue of byte messages, living in a given memory block.
+ * Works across processes when the block is shared, one process writing and another one reading.
+ */
+class SharedRing {
+private:
+    struct Header {
+        std::atomic<std::uint64_t> head; /// total number of bytes written
+        std::atomic<std::uint64_t> tail; /// total number of bytes read
+        std::uint64_t capacity;
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+    Header *header;
+    std::uint8_t *buffer;
+
+    /**
+     * Copy bytes into the buffer starting at a given position, wrapping around its end.
+     */
+    void copy_in(std::uint64_t position, const void *data, std::size_t size);
+
+    /**
+     * Copy bytes from the buffer starting at a given position, wrapping around its end.
+     */
+    void copy_out(std::uint64_t position, void *data, std::size_t size) const;
+
+public:
+    /**
+     * Calculate size of memory needed for a ring.
+     * @param capacity capacity of the ring in bytes
+     * @return required memory size
+     */
+    static std::size_t required_size(std::size_t capacity);
+
+    /**
+     * Attach to a ring in a given memory block.
+     * @param memory memory block of at least required_size(capacity) bytes
+     * @param capacity capacity of the ring in bytes
+     * @param initialise true if the ring should be created empty (done once, before other processes attach)
+     */
+    SharedRing(std::uint8_t *memory, std::size_t capacity, bool initialise);
+
+    /**
+     * Append a message. Called only by the producer.
+     * @param data message bytes
+     * @param size message size
+     * @return false if there was not enough free space (nothing is written)
+     */
+    bool push(const void *data, std::uint32_t size);
+
+    /**
+     * Remove the oldest message. Called only by the consumer.
+     * @param message vector the message is stored in
+     * @return false if the ring was empty
+     */
+    bool pop(std::vector<std::uint8_t> &message);
+};
+
+
+#endif //NEAT_SHAREDMEMORY_H
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <atomic>
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int thread_count) {
+    if (thread_count <= 0) thread_count = (int) std::max(1u, std::thread::hardware_concurrency());
+
+    workers.reserve(thread_count);
+    for (int i = 0; i < thread_count; i++) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    task_available.notify_all();
+
+    for (auto &worker: workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::work() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            task_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    task_available.notify_one();
+}
+
+void ThreadPool::parallel_for(int n, const std::function<void(int)> &body) {
+    parallel_for_slots(n, [&body](int i, int) { body(i); });
+}
+
+void ThreadPool::parallel_for_slots(int n, const std::function<void(int, int)> &body) {
+    std::atomic<int> next = 0;
+    const int task_count = std::min(n, thread_count());
+    int running = task_count;
+
+    std::mutex done_mutex;
+    std::condition_variable done;
+
+    for (int t = 0; t < task_count; t++) {
+        submit([&, t] {
+            for (int i = next++; i < n; i = next++) {
+                body(i, t);
+            }
+
+            std::lock_guard lock(done_mutex);
+            if (--running == 0) done.notify_one();
+        });
+    }
+
+    std::unique_lock lock(done_mutex);
+    done.wait(lock, [&running] { return running == 0; });
+}
+
+int ThreadPool::thread_count() const {
+    return (int) workers.size();
+}
@@ -0,0 +1,69 @@
+#ifndef NEAT_THREADPOOL_H
+#define NEAT_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads executing submitted tasks.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable task_available;
+    bool stopping = false;
+
+    /**
+     * Loop executed by each worker thread.
+     */
+    void work();
+
+public:
+    /**
+     * Start worker threads.
+     * @param thread_count number of threads (number of hardware threads if not positive)
+     */
+    explicit ThreadPool(int thread_count = 0);
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * Finish all submitted tasks, then stop worker threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * Queue a task for execution on some worker thread.
+     * @param task task to execute
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * Call body for every index in [0, n) on worker threads and wait until all calls finish.
+     * Indices are handed out dynamically, so uneven call durations are balanced.
+     * @param n number of indices
+     * @param body function called with each index
+     */
+    void parallel_for(int n, const std::function<void(int)> &body);
+
+    /**
+     * Like parallel_for, but body also gets a slot in [0, thread_count()). Calls running at the same time have
+     * different slots, so the slot can index state reused by the calls of one worker.
+     * @param n number of indices
+     * @param body function called with each index and a slot
+     */
+    void parallel_for_slots(int n, const std::function<void(int, int)> &body);
+
+    [[nodiscard]] int thread_count() const;
+};
+
+
+#endif //NEAT_THREADPOOL_H